@@ -0,0 +1,115 @@
+// async_logger.cpp - NovaEngine asenkron log altyapısı implementation
+#include "async_logger.h"
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
+#include <chrono>
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : min_level_(std::min(NOVA_LOG_LEVEL, NOVA_LOG_LEVEL_ERROR)), dropped_(0),
+      reported_dropped_(0), running_(true) {
+    drain_thread_ = std::thread(&AsyncLogger::drain_loop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    running_ = false;
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+    drain_once();
+}
+
+AsyncLogger::RingHandle::~RingHandle() {
+    if (ring) {
+        ring->orphaned.store(true, std::memory_order_release);
+    }
+}
+
+AsyncLogger::ThreadRing& AsyncLogger::local_ring() {
+    thread_local RingHandle handle;
+    if (!handle.ring) {
+        handle.ring = std::make_shared<ThreadRing>();
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(handle.ring);
+    }
+    return *handle.ring;
+}
+
+void AsyncLogger::log(LogLevel level, const char* format, ...) {
+    ThreadRing& ring = local_ring();
+    LogRecord* record = ring.queue.try_reserve();
+    if (!record) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(record->text, LOG_RECORD_SIZE, format, args);
+    va_end(args);
+
+    record->level = level;
+    record->length = static_cast<uint16_t>(std::clamp<int>(written, 0, LOG_RECORD_SIZE - 1));
+    ring.queue.commit_push();
+}
+
+void AsyncLogger::flush() {
+    drain_once();
+}
+
+size_t AsyncLogger::drain_once() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+
+    size_t drained = 0;
+    bool wrote_out = false;
+    bool wrote_err = false;
+
+    for (auto it = rings_.begin(); it != rings_.end();) {
+        ThreadRing& ring = **it;
+        // Sahip thread'in son yazdıkları da görünsün diye orphaned boşaltmadan önce okunur
+        const bool orphaned = ring.orphaned.load(std::memory_order_acquire);
+
+        while (LogRecord* record = ring.queue.front()) {
+            const bool is_error = record->level >= LogLevel::WARN;
+            FILE* out = is_error ? stderr : stdout;
+            fwrite(record->text, 1, record->length, out);
+            fputc('\n', out);
+            wrote_err |= is_error;
+            wrote_out |= !is_error;
+            ring.queue.pop_front();
+            drained++;
+        }
+
+        if (orphaned) {
+            it = rings_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        fprintf(stderr, "⚠️ %llu log kaydı düşürüldü (halka dolu)\n",
+                static_cast<unsigned long long>(dropped - reported_dropped_));
+        reported_dropped_ = dropped;
+        wrote_err = true;
+    }
+
+    // Her kayıt yerine parti başına bir flush
+    if (wrote_out) fflush(stdout);
+    if (wrote_err) fflush(stderr);
+    return drained;
+}
+
+void AsyncLogger::drain_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain_once() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
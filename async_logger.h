@@ -0,0 +1,115 @@
+// async_logger.h - NovaEngine asenkron log altyapısı
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "spsc_queue.h"
+
+// Log seviyeleri (derleme zamanı filtresi için sayısal)
+#define NOVA_LOG_LEVEL_DEBUG 0
+#define NOVA_LOG_LEVEL_INFO  1
+#define NOVA_LOG_LEVEL_WARN  2
+#define NOVA_LOG_LEVEL_ERROR 3
+#define NOVA_LOG_LEVEL_OFF   4
+
+// Bu seviyenin altındaki çağrılar derlenmez (ör. -DNOVA_LOG_LEVEL=0 ile slice logları açılır)
+#ifndef NOVA_LOG_LEVEL
+#define NOVA_LOG_LEVEL NOVA_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t {
+    DEBUG = NOVA_LOG_LEVEL_DEBUG,
+    INFO = NOVA_LOG_LEVEL_INFO,
+    WARN = NOVA_LOG_LEVEL_WARN,
+    ERROR = NOVA_LOG_LEVEL_ERROR
+};
+
+constexpr size_t LOG_RECORD_SIZE = 256;        // Kayıt başına sabit boyut (uzun mesajlar kesilir)
+constexpr size_t LOG_RING_CAPACITY = 1024;     // Thread başına kayıt sayısı
+
+// Her thread kendi lock-free halkasına printf biçimli kayıt yazar; tek bir drain thread'i
+// halkaları toplu halde stdout (DEBUG/INFO) veya stderr (WARN/ERROR) üzerine boşaltır.
+// Sıcak yolda kilit, allocation veya sistem çağrısı yoktur; halka doluysa kayıt düşürülür
+// ve düşürülen sayısı periyodik olarak raporlanır.
+class AsyncLogger {
+public:
+    static AsyncLogger& instance();
+
+    bool enabled(LogLevel level) const {
+        return static_cast<uint8_t>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+    void set_level(LogLevel level) { min_level_.store(static_cast<uint8_t>(level)); }
+
+    void log(LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    // Bekleyen tüm kayıtları yaz (çıkış öncesi veya std::cout ile sıralama gerektiğinde)
+    void flush();
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+    ~AsyncLogger();
+
+private:
+    struct LogRecord {
+        LogLevel level;
+        uint16_t length;
+        char text[LOG_RECORD_SIZE];
+    };
+
+    struct ThreadRing {
+        SpscQueue<LogRecord> queue{LOG_RING_CAPACITY};
+        std::atomic<bool> orphaned{false};   // Sahibi thread sonlandı, boşalınca kaldırılır
+    };
+
+    struct RingHandle {
+        std::shared_ptr<ThreadRing> ring;
+        ~RingHandle();
+    };
+
+    AsyncLogger();
+    ThreadRing& local_ring();
+    void drain_loop();
+    size_t drain_once();
+
+    std::mutex rings_mutex_;                            // Yalnızca kayıt/kaldırma ve drain
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+    std::atomic<uint8_t> min_level_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t reported_dropped_;
+    std::atomic<bool> running_;
+    std::thread drain_thread_;
+};
+
+#define NOVA_LOG_AT(level, ...) \
+    do { \
+        AsyncLogger& nova_logger_ = AsyncLogger::instance(); \
+        if (nova_logger_.enabled(level)) nova_logger_.log(level, __VA_ARGS__); \
+    } while (0)
+
+#if NOVA_LOG_LEVEL <= NOVA_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) NOVA_LOG_AT(LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if NOVA_LOG_LEVEL <= NOVA_LOG_LEVEL_INFO
+#define LOG_INFO(...) NOVA_LOG_AT(LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if NOVA_LOG_LEVEL <= NOVA_LOG_LEVEL_WARN
+#define LOG_WARN(...) NOVA_LOG_AT(LogLevel::WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if NOVA_LOG_LEVEL <= NOVA_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) NOVA_LOG_AT(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
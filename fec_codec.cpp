@@ -0,0 +1,306 @@
+// fec_codec.cpp - NovaEngine GF(256) Reed-Solomon FEC implementation
+#include "fec_codec.h"
+#include <cstring>
+#include <utility>
+#include <arpa/inet.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NOVA_FEC_X86 1
+#endif
+
+namespace {
+
+// GF(2^8), indirgeme polinomu x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
+struct Gf256Tables {
+    uint8_t exp[512];
+    uint8_t log[256];
+    alignas(16) uint8_t mul_lo[256][16]; // coef * (x & 0x0f)
+    alignas(16) uint8_t mul_hi[256][16]; // coef * (x & 0xf0)
+
+    Gf256Tables() {
+        uint16_t x = 1;
+        for (int i = 0; i < 255; ++i) {
+            exp[i] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) x ^= 0x11D;
+        }
+        for (int i = 255; i < 512; ++i) {
+            exp[i] = exp[i - 255];
+        }
+        log[0] = 0;
+
+        for (int c = 0; c < 256; ++c) {
+            for (int n = 0; n < 16; ++n) {
+                mul_lo[c][n] = mul(static_cast<uint8_t>(c), static_cast<uint8_t>(n));
+                mul_hi[c][n] = mul(static_cast<uint8_t>(c), static_cast<uint8_t>(n << 4));
+            }
+        }
+    }
+
+    uint8_t mul(uint8_t a, uint8_t b) const {
+        if (a == 0 || b == 0) return 0;
+        return exp[log[a] + log[b]];
+    }
+
+    uint8_t inv(uint8_t a) const {
+        return exp[255 - log[a]];
+    }
+};
+
+const Gf256Tables& gf_tables() {
+    static const Gf256Tables tables;
+    return tables;
+}
+
+using MulAddFn = void (*)(uint8_t*, const uint8_t*, const uint8_t*, const uint8_t*, size_t);
+
+void mul_add_scalar(uint8_t* dst, const uint8_t* src, const uint8_t* lo, const uint8_t* hi, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] ^= lo[src[i] & 0x0f] ^ hi[src[i] >> 4];
+    }
+}
+
+#ifdef NOVA_FEC_X86
+__attribute__((target("ssse3")))
+void mul_add_ssse3(uint8_t* dst, const uint8_t* src, const uint8_t* lo, const uint8_t* hi, size_t len) {
+    const __m128i lo_tbl = _mm_load_si128(reinterpret_cast<const __m128i*>(lo));
+    const __m128i hi_tbl = _mm_load_si128(reinterpret_cast<const __m128i*>(hi));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i l = _mm_and_si128(s, nibble);
+        __m128i h = _mm_and_si128(_mm_srli_epi64(s, 4), nibble);
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo_tbl, l), _mm_shuffle_epi8(hi_tbl, h));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(d, p));
+    }
+    mul_add_scalar(dst + i, src + i, lo, hi, len - i);
+}
+
+__attribute__((target("avx2")))
+void mul_add_avx2(uint8_t* dst, const uint8_t* src, const uint8_t* lo, const uint8_t* hi, size_t len) {
+    const __m256i lo_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lo)));
+    const __m256i hi_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(hi)));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i l = _mm256_and_si256(s, nibble);
+        __m256i h = _mm256_and_si256(_mm256_srli_epi64(s, 4), nibble);
+        __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo_tbl, l), _mm256_shuffle_epi8(hi_tbl, h));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, p));
+    }
+    mul_add_scalar(dst + i, src + i, lo, hi, len - i);
+}
+#endif
+
+struct KernelChoice {
+    MulAddFn fn;
+    const char* name;
+};
+
+KernelChoice select_kernel() {
+#ifdef NOVA_FEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {mul_add_avx2, "avx2"};
+    if (__builtin_cpu_supports("ssse3")) return {mul_add_ssse3, "ssse3"};
+#endif
+    return {mul_add_scalar, "scalar"};
+}
+
+const KernelChoice& kernel() {
+    static const KernelChoice choice = select_kernel();
+    return choice;
+}
+
+// Blok içindeki Cauchy katsayısı: 1 / (x_p + y_i), x_p = kb + p, y_i = i
+inline uint8_t cauchy_coef(uint16_t kb, uint16_t p, uint16_t i) {
+    return gf_tables().inv(static_cast<uint8_t>((kb + p) ^ i));
+}
+
+inline bool test_bit(const uint64_t* mask, size_t index) {
+    return (mask[index >> 6] >> (index & 63)) & 1;
+}
+
+} // namespace
+
+void gf256_mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t len) {
+    if (coef == 0) return;
+    if (coef == 1) {
+        // Saf XOR (derleyici vektörleştirir)
+        for (size_t i = 0; i < len; ++i) {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+    const auto& t = gf_tables();
+    kernel().fn(dst, src, t.mul_lo[coef], t.mul_hi[coef], len);
+}
+
+const char* gf256_kernel_name() {
+    return kernel().name;
+}
+
+FecCodec::FecCodec() {
+    gf_tables();
+}
+
+uint16_t FecCodec::block_count(uint16_t total_slices, uint8_t parity_per_block) {
+    if (parity_per_block == 0 || parity_per_block > FEC_MAX_PARITY_PER_BLOCK || total_slices == 0) {
+        return 0;
+    }
+    const size_t max_data = FEC_MAX_SHARDS - parity_per_block;
+    return static_cast<uint16_t>((total_slices + max_data - 1) / max_data);
+}
+
+uint16_t FecCodec::parity_slice_count(uint16_t total_slices, uint8_t parity_per_block) {
+    return static_cast<uint16_t>(block_count(total_slices, parity_per_block) * parity_per_block);
+}
+
+bool FecCodec::encode(const uint8_t* frame_data, size_t frame_size, uint32_t stride,
+                      uint16_t total_slices, uint8_t parity_per_block,
+                      std::vector<std::vector<uint8_t>>& parity_payloads) {
+    const uint16_t blocks = block_count(total_slices, parity_per_block);
+    const size_t parity_count = static_cast<size_t>(blocks) * parity_per_block;
+    const size_t head_size = static_cast<size_t>(total_slices - 1) * stride;
+    if (blocks == 0 || stride == 0 || parity_count > FEC_MAX_PARITY_SLICES ||
+        frame_size <= head_size || frame_size > head_size + stride) {
+        return false;
+    }
+
+    // Son slice stride'a sıfırla tamamlanır
+    padded_tail_.assign(stride, 0);
+    std::memcpy(padded_tail_.data(), frame_data + head_size, frame_size - head_size);
+
+    parity_payloads.resize(parity_count);
+    for (auto& payload : parity_payloads) {
+        payload.assign(FEC_PARITY_PREFIX_SIZE + stride, 0);
+        uint32_t size_be = htonl(static_cast<uint32_t>(frame_size));
+        std::memcpy(payload.data(), &size_be, sizeof(size_be));
+    }
+
+    for (uint16_t b = 0; b < blocks; ++b) {
+        const uint16_t kb = static_cast<uint16_t>((total_slices - b + blocks - 1) / blocks);
+        for (uint16_t p = 0; p < parity_per_block; ++p) {
+            uint8_t* dst = parity_payloads[b * parity_per_block + p].data() + FEC_PARITY_PREFIX_SIZE;
+            for (uint16_t i = 0; i < kb; ++i) {
+                const size_t j = b + static_cast<size_t>(i) * blocks;
+                const uint8_t* src = (j == total_slices - 1u) ? padded_tail_.data() : frame_data + j * stride;
+                gf256_mul_add_region(dst, src, cauchy_coef(kb, p, i), stride);
+            }
+        }
+    }
+    return true;
+}
+
+bool FecCodec::recover(uint8_t* data, const uint8_t* parity, uint32_t stride,
+                       uint16_t total_slices, uint8_t parity_per_block,
+                       const uint64_t* data_mask, const uint64_t* parity_mask) {
+    const uint16_t blocks = block_count(total_slices, parity_per_block);
+    if (blocks == 0 || static_cast<size_t>(blocks) * parity_per_block > FEC_MAX_PARITY_SLICES) {
+        return false;
+    }
+
+    // Önce her bloğun çözülebilir olduğunu doğrula (yarım kurtarma yapılmaz)
+    for (uint16_t b = 0; b < blocks; ++b) {
+        size_t missing = 0;
+        for (size_t j = b; j < total_slices; j += blocks) {
+            if (!test_bit(data_mask, j)) missing++;
+        }
+        size_t available = 0;
+        for (uint16_t p = 0; p < parity_per_block; ++p) {
+            if (test_bit(parity_mask, b * parity_per_block + p)) available++;
+        }
+        if (missing > available) return false;
+    }
+
+    for (uint16_t b = 0; b < blocks; ++b) {
+        const uint16_t kb = static_cast<uint16_t>((total_slices - b + blocks - 1) / blocks);
+
+        missing_.clear();
+        for (uint16_t i = 0; i < kb; ++i) {
+            if (!test_bit(data_mask, b + static_cast<size_t>(i) * blocks)) missing_.push_back(i);
+        }
+        if (missing_.empty()) continue;
+
+        const size_t e = missing_.size();
+        parity_rows_.clear();
+        for (uint16_t p = 0; p < parity_per_block && parity_rows_.size() < e; ++p) {
+            if (test_bit(parity_mask, b * parity_per_block + p)) parity_rows_.push_back(p);
+        }
+
+        // Sendromlar: parity - sum(c * bilinen veri)
+        syndromes_.resize(e * stride);
+        for (size_t t = 0; t < e; ++t) {
+            uint8_t* syn = syndromes_.data() + t * stride;
+            std::memcpy(syn, parity + static_cast<size_t>(b * parity_per_block + parity_rows_[t]) * stride, stride);
+            for (uint16_t i = 0; i < kb; ++i) {
+                const size_t j = b + static_cast<size_t>(i) * blocks;
+                if (!test_bit(data_mask, j)) continue;
+                gf256_mul_add_region(syn, data + j * stride, cauchy_coef(kb, parity_rows_[t], i), stride);
+            }
+        }
+
+        // Eksik sütunlara ait Cauchy alt matrisini ters çevir
+        matrix_.resize(e * e);
+        for (size_t t = 0; t < e; ++t) {
+            for (size_t u = 0; u < e; ++u) {
+                matrix_[t * e + u] = cauchy_coef(kb, parity_rows_[t], missing_[u]);
+            }
+        }
+        if (!invert_matrix(e)) return false;
+
+        // Eksik veri = ters matris * sendromlar, doğrudan frame buffer'ına yazılır
+        for (size_t u = 0; u < e; ++u) {
+            uint8_t* out = data + (b + static_cast<size_t>(missing_[u]) * blocks) * stride;
+            std::memset(out, 0, stride);
+            for (size_t t = 0; t < e; ++t) {
+                gf256_mul_add_region(out, syndromes_.data() + t * stride, inverse_[u * e + t], stride);
+            }
+        }
+    }
+    return true;
+}
+
+bool FecCodec::invert_matrix(size_t n) {
+    const auto& gf = gf_tables();
+    inverse_.assign(n * n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        inverse_[i * n + i] = 1;
+    }
+
+    // Gauss-Jordan eliminasyonu (GF(256) üzerinde toplama = XOR)
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        while (pivot < n && matrix_[pivot * n + col] == 0) pivot++;
+        if (pivot == n) return false;
+        if (pivot != col) {
+            for (size_t k = 0; k < n; ++k) {
+                std::swap(matrix_[pivot * n + k], matrix_[col * n + k]);
+                std::swap(inverse_[pivot * n + k], inverse_[col * n + k]);
+            }
+        }
+
+        const uint8_t scale = gf.inv(matrix_[col * n + col]);
+        for (size_t k = 0; k < n; ++k) {
+            matrix_[col * n + k] = gf.mul(matrix_[col * n + k], scale);
+            inverse_[col * n + k] = gf.mul(inverse_[col * n + k], scale);
+        }
+
+        for (size_t row = 0; row < n; ++row) {
+            const uint8_t factor = matrix_[row * n + col];
+            if (row == col || factor == 0) continue;
+            for (size_t k = 0; k < n; ++k) {
+                matrix_[row * n + k] ^= gf.mul(factor, matrix_[col * n + k]);
+                inverse_[row * n + k] ^= gf.mul(factor, inverse_[col * n + k]);
+            }
+        }
+    }
+    return true;
+}
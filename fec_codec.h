@@ -0,0 +1,55 @@
+// fec_codec.h - NovaEngine GF(256) Reed-Solomon FEC
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// FEC sabitleri
+constexpr size_t FEC_MAX_SHARDS = 255;              // GF(256) blok başına maksimum (veri + parity)
+constexpr uint8_t FEC_MAX_PARITY_PER_BLOCK = 63;    // SliceHeader::reserved içindeki 6 bit
+constexpr uint16_t FEC_MAX_PARITY_SLICES = 256;     // Frame başına maksimum parity slice
+constexpr size_t FEC_PARITY_PREFIX_SIZE = 4;        // Parity payload başındaki frame boyutu (big-endian)
+
+// GF(256) bölge kernelleri: dst ^= coef * src
+// Çalışma anında AVX2 / SSSE3 (pshufb nibble tabloları) veya scalar sürüm seçilir.
+void gf256_mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t len);
+const char* gf256_kernel_name();
+
+// Sistematik Cauchy Reed-Solomon kodlayıcı/çözücü.
+//
+// Frame'in total_slices veri slice'ı, blok başına en fazla FEC_MAX_SHARDS shard olacak
+// şekilde block_count() bloğa dağıtılır (slice j -> blok j % block_count, burst kayıplar
+// bloklara yayılır). Her blok parity_per_block (m) parity shard taşır; parity slice q
+// blok q / m'nin q % m'inci parity'sidir. Son veri slice'ı stride'a sıfırla tamamlanır.
+class FecCodec {
+public:
+    FecCodec();
+
+    static uint16_t block_count(uint16_t total_slices, uint8_t parity_per_block);
+    static uint16_t parity_slice_count(uint16_t total_slices, uint8_t parity_per_block);
+
+    // Gönderici tarafı: frame için parity payload'larını üret (her biri prefix + stride byte)
+    bool encode(const uint8_t* frame_data, size_t frame_size, uint32_t stride,
+                uint16_t total_slices, uint8_t parity_per_block,
+                std::vector<std::vector<uint8_t>>& parity_payloads);
+
+    // Alıcı tarafı: eksik veri slice'larını yerinde yeniden oluştur.
+    // data: total_slices * stride byte (eksik konumlar yazılır, son slice dolgusu sıfır olmalı)
+    // parity: parity_slice_count * stride byte (prefix'siz)
+    // data_mask / parity_mask: alınan slice bitmap'leri
+    bool recover(uint8_t* data, const uint8_t* parity, uint32_t stride,
+                 uint16_t total_slices, uint8_t parity_per_block,
+                 const uint64_t* data_mask, const uint64_t* parity_mask);
+
+private:
+    // Çözüm için yeniden kullanılan çalışma alanları
+    std::vector<uint8_t> syndromes_;
+    std::vector<uint8_t> matrix_;
+    std::vector<uint8_t> inverse_;
+    std::vector<uint8_t> padded_tail_;
+    std::vector<uint16_t> missing_;
+    std::vector<uint16_t> parity_rows_;
+
+    bool invert_matrix(size_t n);
+};
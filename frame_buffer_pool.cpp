@@ -0,0 +1,70 @@
+// frame_buffer_pool.cpp - NovaEngine yeniden kullanılabilir frame buffer havuzu implementation
+#include "frame_buffer_pool.h"
+#include <utility>
+
+FrameBufferPool::FrameBufferPool(size_t max_pooled_buffers)
+    : max_pooled_buffers_(max_pooled_buffers), allocation_count_(0) {
+    free_buffers_.reserve(max_pooled_buffers_);
+}
+
+std::vector<uint8_t> FrameBufferPool::acquire(size_t min_size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (free_buffers_.empty()) {
+        allocation_count_++;
+        lock.unlock();
+        return std::vector<uint8_t>(min_size);
+    }
+    
+    // Yeterince büyük en küçük buffer'ı seç, yoksa en büyüğünü büyüt
+    size_t best = 0;
+    bool fits = false;
+    for (size_t i = 0; i < free_buffers_.size(); ++i) {
+        size_t size = free_buffers_[i].size();
+        if (size >= min_size) {
+            if (!fits || size < free_buffers_[best].size()) {
+                best = i;
+                fits = true;
+            }
+        } else if (!fits && size > free_buffers_[best].size()) {
+            best = i;
+        }
+    }
+    
+    std::vector<uint8_t> buffer = std::move(free_buffers_[best]);
+    free_buffers_[best] = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    
+    if (buffer.size() < min_size) {
+        if (buffer.capacity() < min_size) {
+            allocation_count_++;
+        }
+        lock.unlock();
+        buffer.resize(min_size);
+    }
+    return buffer;
+}
+
+void FrameBufferPool::release(std::vector<uint8_t>&& buffer) {
+    if (buffer.capacity() == 0) {
+        return;
+    }
+    
+    // Kapasitenin tamamını kullanılabilir tut (küçültülmüş size sadece teslim içindi)
+    buffer.resize(buffer.capacity());
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_buffers_.size() >= max_pooled_buffers_) {
+        return; // Havuz dolu, buffer serbest bırakılır
+    }
+    free_buffers_.push_back(std::move(buffer));
+}
+
+size_t FrameBufferPool::allocation_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocation_count_;
+}
+
+size_t FrameBufferPool::pooled_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_buffers_.size();
+}
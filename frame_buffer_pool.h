@@ -0,0 +1,33 @@
+// frame_buffer_pool.h - NovaEngine yeniden kullanılabilir frame buffer havuzu
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Reassembly sırasında slice'ların doğrudan yerleştirildiği birleşik frame buffer'larını
+// tekrar kullanır. Havuzdaki buffer'ların size() değeri kapasitelerine eşit tutulur,
+// böylece tekrar alındıklarında yeniden sıfırlama/allocation gerekmez.
+// Buffer'lar başka bir thread'de (teslim aşaması) iade edilebildiği için havuz kilitlidir;
+// kilit frame başına bir kez alınır, slice başına değil.
+class FrameBufferPool {
+public:
+    explicit FrameBufferPool(size_t max_pooled_buffers = 16);
+    
+    // En az min_size byte'lık bir buffer ver (size() >= min_size)
+    std::vector<uint8_t> acquire(size_t min_size);
+    
+    // Buffer'ı havuza geri ver (havuz doluysa serbest bırakılır)
+    void release(std::vector<uint8_t>&& buffer);
+    
+    // İstatistikler
+    size_t allocation_count() const;
+    size_t pooled_count() const;
+    
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::vector<uint8_t>> free_buffers_;
+    size_t max_pooled_buffers_;
+    size_t allocation_count_;
+};
@@ -0,0 +1,214 @@
+// frame_delivery.cpp - NovaEngine sıralı frame teslim aşaması implementation
+#include "frame_delivery.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+FrameDeliveryStage::FrameDeliveryStage(size_t producer_count, size_t window_size,
+                                       std::chrono::milliseconds playout_delay,
+                                       CompleteCallback on_complete, DiscardCallback on_discard)
+    : pending_(window_size), pending_count_(0), next_frame_id_(0), has_next_(false), delivered_any_(false),
+      playout_delay_(playout_delay), on_complete_(std::move(on_complete)), on_discard_(std::move(on_discard)),
+      event_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), running_(false) {
+    for (size_t i = 0; i < producer_count; ++i) {
+        queues_.push_back(std::make_unique<SpscQueue<CompletedFrame>>(window_size));
+    }
+}
+
+FrameDeliveryStage::~FrameDeliveryStage() {
+    stop();
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+}
+
+bool FrameDeliveryStage::push(size_t producer, CompletedFrame&& frame) {
+    if (!queues_[producer]->try_push(std::move(frame))) {
+        return false;
+    }
+    uint64_t one = 1;
+    ssize_t written = write(event_fd_, &one, sizeof(one));
+    (void)written; // Sayaç taşsa bile tüketici zaten uyanık
+    return true;
+}
+
+void FrameDeliveryStage::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&FrameDeliveryStage::run, this);
+}
+
+void FrameDeliveryStage::stop() {
+    if (!running_.exchange(false)) return;
+    uint64_t one = 1;
+    ssize_t written = write(event_fd_, &one, sizeof(one));
+    (void)written;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void FrameDeliveryStage::run() {
+    while (running_) {
+        // Sıradaki frame bekleniyorsa en geç gap deadline'ında uyan
+        int timeout_ms = 100;
+        if (gap_deadline_ != std::chrono::steady_clock::time_point{}) {
+            auto remaining = gap_deadline_ - std::chrono::steady_clock::now();
+            auto remaining_ms = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+            timeout_ms = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(remaining_ms, timeout_ms)));
+        }
+
+        struct pollfd pfd;
+        pfd.fd = event_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, timeout_ms) > 0) {
+            uint64_t count;
+            ssize_t got = read(event_fd_, &count, sizeof(count));
+            (void)got;
+        }
+
+        CompletedFrame frame;
+        for (auto& queue : queues_) {
+            while (queue->try_pop(frame)) {
+                accept(std::move(frame));
+            }
+        }
+
+        release_ready(std::chrono::steady_clock::now());
+    }
+
+    // Kalan buffer'ları havuzlarına iade et
+    CompletedFrame frame;
+    for (auto& queue : queues_) {
+        while (queue->try_pop(frame)) {
+            if (frame.pool) frame.pool->release(std::move(frame.data));
+        }
+    }
+    for (auto& pending : pending_) {
+        if (pending.filled && pending.frame.pool) {
+            pending.frame.pool->release(std::move(pending.frame.data));
+        }
+        pending.filled = false;
+    }
+    pending_count_ = 0;
+}
+
+void FrameDeliveryStage::accept(CompletedFrame&& frame) {
+    if (!has_next_) {
+        next_frame_id_ = frame.frame_id;
+        has_next_ = true;
+    }
+
+    const int32_t distance = static_cast<int32_t>(frame.frame_id - next_frame_id_);
+    if (distance < 0) {
+        if (!delivered_any_ && -distance < static_cast<int32_t>(pending_.size() / 2)) {
+            // Başlangıçta ilk gelen frame'den önceki bir frame tamamlandı: sırayı geriye al
+            next_frame_id_ = frame.frame_id;
+        } else {
+            // Sırası geçmiş (deadline'ı kaçırıp atlanmış) frame, teslim edilmez
+            if (frame.pool) frame.pool->release(std::move(frame.data));
+            return;
+        }
+    }
+
+    if (distance >= static_cast<int32_t>(pending_.size())) {
+        // Pencereden büyük sıçrama (ör. gönderici yeniden başladı): bekleyenleri sırayla boşalt
+        LOG_INFO("⚠️ Teslim sırası %u -> %u atladı", next_frame_id_, frame.frame_id);
+        const auto now = std::chrono::steady_clock::now();
+        while (pending_count_ > 0) {
+            auto& pending = slot(next_frame_id_);
+            if (pending.filled) {
+                emit(pending.frame, now);
+                pending.filled = false;
+                pending_count_--;
+                next_frame_id_++;
+            } else {
+                skip_next();
+            }
+        }
+        next_frame_id_ = frame.frame_id;
+        gap_deadline_ = std::chrono::steady_clock::time_point{};
+    }
+
+    auto& pending = slot(frame.frame_id);
+    if (pending.filled) {
+        if (frame.pool) frame.pool->release(std::move(frame.data)); // Aynı frame iki kez bildirildi
+        return;
+    }
+
+    // Bloke iken daha erken deadline'lı bir frame gelirse gap deadline'ı öne çek
+    const auto deadline = frame.first_slice_time + playout_delay_;
+    if (gap_deadline_ != std::chrono::steady_clock::time_point{} && deadline < gap_deadline_) {
+        gap_deadline_ = deadline;
+    }
+
+    pending.frame = std::move(frame);
+    pending.filled = true;
+    pending_count_++;
+}
+
+void FrameDeliveryStage::release_ready(std::chrono::steady_clock::time_point now) {
+    while (pending_count_ > 0) {
+        auto& pending = slot(next_frame_id_);
+        if (pending.filled) {
+            // İlk frame'den önceki frame'ler hâlâ tamamlanıyor olabilir: ilk teslim deadline'a kadar tutulur
+            const auto deadline = pending.frame.first_slice_time + playout_delay_;
+            if (!delivered_any_ && now < deadline) {
+                gap_deadline_ = deadline;
+                break;
+            }
+            emit(pending.frame, now);
+            pending.filled = false;
+            pending_count_--;
+            next_frame_id_++;
+            delivered_any_ = true;
+            gap_deadline_ = std::chrono::steady_clock::time_point{};
+            continue;
+        }
+
+        // Sıradaki frame'den haber yok: bekleyenlerin en erken playout deadline'ına kadar bekle
+        if (gap_deadline_ == std::chrono::steady_clock::time_point{}) {
+            gap_deadline_ = std::chrono::steady_clock::time_point::max();
+            for (const auto& waiting : pending_) {
+                if (waiting.filled) {
+                    gap_deadline_ = std::min(gap_deadline_, waiting.frame.first_slice_time + playout_delay_);
+                }
+            }
+        }
+        if (now < gap_deadline_) {
+            break;
+        }
+        skip_next();
+    }
+
+    if (pending_count_ == 0) {
+        gap_deadline_ = std::chrono::steady_clock::time_point{};
+    }
+}
+
+void FrameDeliveryStage::emit(CompletedFrame& frame, std::chrono::steady_clock::time_point now) {
+    if (frame.discarded) {
+        if (on_discard_) on_discard_(frame.frame_id);
+    } else if (on_complete_) {
+        FrameTiming timing;
+        timing.first_slice_time = frame.first_slice_time;
+        timing.completed_time = frame.completed_time;
+        timing.playout_deadline = frame.first_slice_time + playout_delay_;
+        timing.delivered_time = now;
+        on_complete_(frame, timing);
+    }
+    if (frame.pool) {
+        frame.pool->release(std::move(frame.data));
+        frame.pool.reset();
+    }
+    frame.data = std::vector<uint8_t>();
+}
+
+void FrameDeliveryStage::skip_next() {
+    // Playout deadline'ına kadar hiçbir worker bu frame'i bildirmedi (tüm slice'lar kayıp)
+    LOG_DEBUG("⏭️ Frame %u playout deadline'ını kaçırdı, atlanıyor", next_frame_id_);
+    if (on_discard_) on_discard_(next_frame_id_);
+    next_frame_id_++;
+}
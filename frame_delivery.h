@@ -0,0 +1,82 @@
+// frame_delivery.h - NovaEngine sıralı frame teslim aşaması
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include "spsc_queue.h"
+#include "frame_buffer_pool.h"
+
+// Reassembly worker'ının teslim aşamasına bıraktığı sonuç (tamamlanan veya atılan frame)
+struct CompletedFrame {
+    uint32_t frame_id = 0;
+    bool discarded = false;
+    std::vector<uint8_t> data;         // Tamamlanan frame verisi (havuz buffer'ı)
+    std::shared_ptr<FrameBufferPool> pool;  // Buffer'ın iade edileceği havuz (handle'lar da tutar)
+    std::chrono::steady_clock::time_point first_slice_time;
+    std::chrono::steady_clock::time_point completed_time;
+};
+
+// Teslim edilen frame'in zamanlaması (lateness = delivered_time - playout_deadline)
+struct FrameTiming {
+    std::chrono::steady_clock::time_point first_slice_time;
+    std::chrono::steady_clock::time_point completed_time;
+    std::chrono::steady_clock::time_point playout_deadline;  // first_slice_time + playout_delay
+    std::chrono::steady_clock::time_point delivered_time;
+};
+
+// Worker'lardan gelen sonuçları lock-free kuyruklardan toplayıp frame_id sırasıyla
+// tek bir thread üzerinden callback'lere verir. Tamamlanan frame hemen, ancak önceki
+// tüm frame'ler teslim edildikten/atıldıktan sonra verilir. Sıradaki frame'den haber
+// yoksa bekleyen sonraki frame'lerin en erken playout deadline'ına (ilk slice + playout_delay)
+// kadar beklenir; deadline geçince eksik frame'ler atlanıp atılmış olarak bildirilir.
+class FrameDeliveryStage {
+public:
+    // Callback frame.data'yı taşıyabilir (ör. FrameHandle'a); kalan buffer havuza döner
+    using CompleteCallback = std::function<void(CompletedFrame&, const FrameTiming&)>;
+    using DiscardCallback = std::function<void(uint32_t)>;
+
+    FrameDeliveryStage(size_t producer_count, size_t window_size,
+                       std::chrono::milliseconds playout_delay,
+                       CompleteCallback on_complete, DiscardCallback on_discard);
+    ~FrameDeliveryStage();
+
+    // Üretici (shard) thread'inden çağrılır; kuyruk doluysa false döner
+    bool push(size_t producer, CompletedFrame&& frame);
+
+    void start();
+    void stop();
+
+private:
+    struct PendingSlot {
+        bool filled = false;
+        CompletedFrame frame;
+    };
+
+    std::vector<std::unique_ptr<SpscQueue<CompletedFrame>>> queues_;
+    std::vector<PendingSlot> pending_;   // frame_id % window -> bekleyen sonuç
+    size_t pending_count_;
+    uint32_t next_frame_id_;             // Sıradaki teslim edilecek frame
+    bool has_next_;
+    bool delivered_any_;                 // İlk teslimden önce daha eski frame'ler sırayı geriye alabilir
+    std::chrono::milliseconds playout_delay_;
+    std::chrono::steady_clock::time_point gap_deadline_;   // Sıradaki eksik frame'in atlanacağı an (boş = bloke değil)
+
+    CompleteCallback on_complete_;
+    DiscardCallback on_discard_;
+
+    int event_fd_;                       // Üreticiler push sonrası uyandırır
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    void run();
+    void accept(CompletedFrame&& frame);
+    void release_ready(std::chrono::steady_clock::time_point now);
+    void emit(CompletedFrame& frame, std::chrono::steady_clock::time_point now);
+    void skip_next();
+    PendingSlot& slot(uint32_t frame_id) { return pending_[frame_id & (pending_.size() - 1)]; }
+};
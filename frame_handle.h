@@ -0,0 +1,71 @@
+// frame_handle.h - NovaEngine sıfır kopyalı, sahiplik taşıyan frame handle'ı
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "frame_buffer_pool.h"
+
+// Frame verisine sahiplik almadan bakış (std::span yerine, C++17)
+struct FrameSpan {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+// Tamamlanan frame'in birleşik buffer'ı. Taşınabilir, kopyalanamaz; yok edildiğinde (veya
+// reset() ile) buffer kopyalanmadan engine'in havuzuna döner. Havuz shared_ptr ile tutulur,
+// böylece handle engine durduktan sonra da (ör. GStreamer'da asenkron tüketim) geçerlidir.
+// Havuz kilitli olduğundan handle herhangi bir thread'de bırakılabilir.
+class FrameHandle {
+public:
+    FrameHandle() : frame_id_(0) {}
+    FrameHandle(uint32_t frame_id, std::vector<uint8_t>&& data, std::shared_ptr<FrameBufferPool> pool)
+        : frame_id_(frame_id), data_(std::move(data)), pool_(std::move(pool)) {}
+    ~FrameHandle() { reset(); }
+
+    FrameHandle(const FrameHandle&) = delete;
+    FrameHandle& operator=(const FrameHandle&) = delete;
+
+    FrameHandle(FrameHandle&& other) noexcept
+        : frame_id_(other.frame_id_), data_(std::move(other.data_)), pool_(std::move(other.pool_)) {
+        other.data_ = std::vector<uint8_t>();
+    }
+    FrameHandle& operator=(FrameHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            frame_id_ = other.frame_id_;
+            data_ = std::move(other.data_);
+            pool_ = std::move(other.pool_);
+            other.data_ = std::vector<uint8_t>();
+        }
+        return *this;
+    }
+
+    uint32_t frame_id() const { return frame_id_; }
+    const uint8_t* data() const { return data_.data(); }
+    size_t size() const { return data_.size(); }
+    bool empty() const { return data_.empty(); }
+    FrameSpan span() const { return FrameSpan{data_.data(), data_.size()}; }
+    // Vektör bekleyen eski API'ler için (kopya yok)
+    const std::vector<uint8_t>& vector() const { return data_; }
+
+    // Buffer'ı havuza iade et
+    void reset() {
+        if (pool_) {
+            pool_->release(std::move(data_));
+            pool_.reset();
+        }
+        data_ = std::vector<uint8_t>();
+    }
+
+private:
+    uint32_t frame_id_;
+    std::vector<uint8_t> data_;
+    std::shared_ptr<FrameBufferPool> pool_;
+};
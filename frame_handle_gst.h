@@ -0,0 +1,21 @@
+// frame_handle_gst.h - FrameHandle'ı kopyalamadan GstBuffer'a sarma (GStreamer hedefleri için)
+#pragma once
+
+#include <gst/gst.h>
+#include "frame_handle.h"
+
+// Handle heap'e taşınır ve buffer'ı salt okunur GstMemory olarak sarılır. GStreamer son
+// referansı bıraktığında destroy-notify handle'ı siler, buffer engine havuzuna döner.
+// offset: buffer'a dahil edilmeyen baştaki byte'lar (ör. uygulama öneki).
+// Boş handle veya offset >= boyut için nullptr döner (handle o durumda bırakılmaz).
+inline GstBuffer* frame_handle_to_gst_buffer(FrameHandle&& handle, size_t offset = 0) {
+    if (handle.size() <= offset) {
+        return nullptr;
+    }
+
+    auto* owned = new FrameHandle(std::move(handle));
+    return gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY,
+                                       const_cast<uint8_t*>(owned->data()), owned->size(),
+                                       offset, owned->size() - offset, owned,
+                                       [](gpointer user_data) { delete static_cast<FrameHandle*>(user_data); });
+}
@@ -0,0 +1,88 @@
+// hdr_histogram.cpp - NovaEngine lock-free HDR gecikme histogramı implementation
+#include "hdr_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+HdrHistogram::HdrHistogram() : total_(0), sum_(0), min_(UINT64_MAX), max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t HdrHistogram::bucket_index(uint64_t value) {
+    value = std::min<uint64_t>(value, (1ull << HDR_MAX_VALUE_BITS) - 1);
+    if (value < 2 * HDR_SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value); // Lineer bölge
+    }
+    // value >> shift, [SUB_BUCKET_COUNT, 2 * SUB_BUCKET_COUNT) aralığına düşer
+    const unsigned shift = (63 - __builtin_clzll(value)) - HDR_SUB_BUCKET_BITS;
+    return (shift + 1) * HDR_SUB_BUCKET_COUNT + ((value >> shift) - HDR_SUB_BUCKET_COUNT);
+}
+
+uint64_t HdrHistogram::bucket_upper_value(size_t index) {
+    if (index < 2 * HDR_SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const unsigned shift = static_cast<unsigned>(index / HDR_SUB_BUCKET_COUNT) - 1;
+    const uint64_t sub = index % HDR_SUB_BUCKET_COUNT + HDR_SUB_BUCKET_COUNT;
+    return (sub << shift) + ((1ull << shift) - 1);
+}
+
+void HdrHistogram::record(uint64_t value) {
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void HdrHistogram::add_to(HistogramCounts& counts) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < HDR_BUCKET_COUNT; ++i) {
+        const uint64_t count = buckets_[i].load(std::memory_order_relaxed);
+        counts.buckets[i] += count;
+        total += count;
+    }
+    // Okuma sırasında gelen kayıtlar yüzünden kovaların toplamı esas alınır
+    counts.total += total;
+    counts.sum += sum_.load(std::memory_order_relaxed);
+    counts.min = std::min(counts.min, min_.load(std::memory_order_relaxed));
+    counts.max = std::max(counts.max, max_.load(std::memory_order_relaxed));
+}
+
+HistogramSnapshot HdrHistogram::snapshot() const {
+    HistogramCounts counts;
+    add_to(counts);
+    return counts.summarize();
+}
+
+uint64_t HistogramCounts::value_at_percentile(double percentile) const {
+    if (total == 0) return 0;
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(HdrHistogram::bucket_upper_value(i), max);
+        }
+    }
+    return max;
+}
+
+HistogramSnapshot HistogramCounts::summarize() const {
+    HistogramSnapshot snapshot;
+    snapshot.count = total;
+    if (total == 0) return snapshot;
+
+    snapshot.min = min;
+    snapshot.max = max;
+    snapshot.mean = static_cast<double>(sum) / static_cast<double>(total);
+    snapshot.p50 = value_at_percentile(50.0);
+    snapshot.p90 = value_at_percentile(90.0);
+    snapshot.p99 = value_at_percentile(99.0);
+    snapshot.p999 = value_at_percentile(99.9);
+    return snapshot;
+}
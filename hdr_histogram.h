@@ -0,0 +1,59 @@
+// hdr_histogram.h - NovaEngine lock-free HDR gecikme histogramı
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Log-lineer kova yapısı: 256'ya kadar birebir, sonrasında her 2'nin kuvveti aralığı
+// 128 alt kovaya bölünür (~%0.8 bağıl hata). 2^36'ya kadar değer tutar (µs ile ~19 saat).
+constexpr unsigned HDR_SUB_BUCKET_BITS = 7;
+constexpr uint64_t HDR_SUB_BUCKET_COUNT = 1ull << HDR_SUB_BUCKET_BITS;
+constexpr unsigned HDR_MAX_VALUE_BITS = 36;
+constexpr size_t HDR_BUCKET_COUNT = (HDR_MAX_VALUE_BITS - HDR_SUB_BUCKET_BITS + 1) * HDR_SUB_BUCKET_COUNT;
+
+// Histogram özeti
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+// Birden çok histogramın (ör. shard'lar) toplanabilen sayaç kopyası
+struct HistogramCounts {
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(HDR_BUCKET_COUNT, 0);
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    uint64_t value_at_percentile(double percentile) const;
+    HistogramSnapshot summarize() const;
+};
+
+// Kayıt relaxed atomik artırmadır; okuyucular (snapshot) worker'ı durdurmadan sayaçları okur.
+class HdrHistogram {
+public:
+    HdrHistogram();
+
+    void record(uint64_t value);
+    void add_to(HistogramCounts& counts) const;
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_upper_value(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, HDR_BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
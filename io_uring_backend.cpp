@@ -0,0 +1,340 @@
+// io_uring_backend.cpp - NovaEngine io_uring alım backend'i implementation
+#include "io_uring_backend.h"
+#include "async_logger.h"
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+} // namespace
+
+IoUringReceiveBackend::IoUringReceiveBackend()
+    : ring_fd_(-1), event_fd_(-1), sq_ring_ptr_(MAP_FAILED), sq_ring_size_(0), cq_ring_ptr_(MAP_FAILED),
+      cq_ring_size_(0), sqes_(nullptr), sqes_size_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_mask_(nullptr),
+      sq_array_(nullptr), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(nullptr), cqes_(nullptr),
+      buf_ring_(nullptr), buf_ring_size_(0), buf_tail_(0), empty_rearms_(0), failed_(false) {
+    memset(&recv_template_, 0, sizeof(recv_template_));
+    recv_template_.msg_namelen = sizeof(sockaddr_in);
+    batch_.reserve(RECV_BATCH_SIZE);
+    used_buffers_.reserve(RECV_BATCH_SIZE);
+}
+
+IoUringReceiveBackend::~IoUringReceiveBackend() {
+    // Ring fd'si kapanınca bekleyen multishot istekleri iptal edilir
+    if (ring_fd_ >= 0) close(ring_fd_);
+    if (event_fd_ >= 0) close(event_fd_);
+    if (buf_ring_) munmap(buf_ring_, buf_ring_size_);
+    if (sqes_) munmap(sqes_, sqes_size_);
+    if (cq_ring_ptr_ != MAP_FAILED && cq_ring_ptr_ != sq_ring_ptr_) munmap(cq_ring_ptr_, cq_ring_size_);
+    if (sq_ring_ptr_ != MAP_FAILED) munmap(sq_ring_ptr_, sq_ring_size_);
+}
+
+bool IoUringReceiveBackend::setup_rings() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = URING_CQ_ENTRIES;
+
+    // SQ yalnızca soket başına bir istek için kullanılır
+    ring_fd_ = io_uring_setup(64, &params);
+    if (ring_fd_ < 0) {
+        LOG_WARN("UYARI: io_uring_setup başarısız: %s", strerror(errno));
+        return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr_ == MAP_FAILED) {
+        LOG_WARN("UYARI: io_uring SQ ring eşlenemedi: %s", strerror(errno));
+        return false;
+    }
+    if (single_mmap) {
+        cq_ring_ptr_ = sq_ring_ptr_;
+    } else {
+        cq_ring_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr_ == MAP_FAILED) {
+            LOG_WARN("UYARI: io_uring CQ ring eşlenemedi: %s", strerror(errno));
+            return false;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_WARN("UYARI: io_uring SQE dizisi eşlenemedi: %s", strerror(errno));
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<uint8_t*>(sq_ring_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    auto* cq = static_cast<uint8_t*>(cq_ring_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+}
+
+bool IoUringReceiveBackend::register_buffers() {
+    buf_ring_size_ = URING_BUFFER_COUNT * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        LOG_WARN("UYARI: Buffer ring ayrılamadı: %s", strerror(errno));
+        return false;
+    }
+    buf_ring_ = static_cast<io_uring_buf_ring*>(ring);
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = URING_BUFFER_COUNT;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (io_uring_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        LOG_WARN("UYARI: Provided buffer ring kaydedilemedi: %s", strerror(errno));
+        return false;
+    }
+
+    // Tüm buffer'ları baştan ring'e ver
+    buffers_.resize(URING_BUFFER_COUNT * BUFFER_SIZE);
+    for (unsigned i = 0; i < URING_BUFFER_COUNT; ++i) {
+        recycle_buffer(static_cast<uint16_t>(i));
+    }
+    publish_buffers();
+    return true;
+}
+
+bool IoUringReceiveBackend::start(int epoll_fd, const std::map<int, uint8_t>& sockets) {
+    if (!setup_rings() || !register_buffers()) {
+        return false;
+    }
+
+    // Completion bildirimi için eventfd
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) {
+        LOG_WARN("UYARI: eventfd oluşturulamadı: %s", strerror(errno));
+        return false;
+    }
+    if (io_uring_register(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) {
+        LOG_WARN("UYARI: io_uring eventfd kaydedilemedi: %s", strerror(errno));
+        return false;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = event_fd_;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd_, &ev) < 0) {
+        LOG_ERROR("HATA: Epoll'e io_uring eventfd eklenemedi: %s", strerror(errno));
+        return false;
+    }
+
+    sockets_ = sockets;
+    return true;
+}
+
+bool IoUringReceiveBackend::arm() {
+    for (const auto& entry : sockets_) {
+        if (!submit_recv(entry.first)) {
+            return false;
+        }
+    }
+
+    // Multishot recvmsg desteklenmiyorsa istek hemen hata ile tamamlanır
+    const unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (unsigned i = head; i != tail; ++i) {
+        const io_uring_cqe& cqe = cqes_[i & *cq_mask_];
+        if (cqe.res < 0 && cqe.res != -ENOBUFS && !(cqe.flags & IORING_CQE_F_MORE)) {
+            LOG_WARN("UYARI: Multishot recvmsg desteklenmiyor: %s", strerror(-cqe.res));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IoUringReceiveBackend::submit_recv(int socket_fd) {
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & *sq_mask_;
+
+    io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = socket_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&recv_template_);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = static_cast<uint64_t>(socket_fd);
+
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    if (io_uring_enter(ring_fd_, 1, 0, 0) != 1) {
+        LOG_ERROR("HATA: io_uring recvmsg gönderilemedi: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void IoUringReceiveBackend::recycle_buffer(uint16_t buffer_id) {
+    // bufs[] kullanılmaz: C++'ta __DECLARE_FLEX_ARRAY'in boş struct'ı diziyi 8 byte kaydırır.
+    // Kernel düzeninde girdiler ring'in başından başlar (ilk girdinin son alanı tail'dir).
+    io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(buf_ring_) + (buf_tail_ & (URING_BUFFER_COUNT - 1));
+    buf->addr = reinterpret_cast<uint64_t>(buffers_.data() + static_cast<size_t>(buffer_id) * BUFFER_SIZE);
+    buf->len = BUFFER_SIZE;
+    buf->bid = buffer_id;
+    ++buf_tail_;
+}
+
+void IoUringReceiveBackend::publish_buffers() {
+    // Kernel buffer içeriklerini tail'den sonra görmeli
+    __atomic_store_n(&buf_ring_->tail, buf_tail_, __ATOMIC_RELEASE);
+}
+
+void IoUringReceiveBackend::flush_batch() {
+    if (!batch_.empty() && handler_) {
+        handler_(batch_.data(), batch_.size(), batch_time_);
+    }
+    batch_.clear();
+
+    // Handler döndükten sonra buffer'lar yeniden kullanılabilir
+    if (!used_buffers_.empty()) {
+        for (uint16_t buffer_id : used_buffers_) {
+            recycle_buffer(buffer_id);
+        }
+        used_buffers_.clear();
+        publish_buffers();
+    }
+}
+
+bool IoUringReceiveBackend::on_readable(int fd) {
+    if (fd != event_fd_) return false;
+
+    uint64_t signals;
+    if (read(event_fd_, &signals, sizeof(signals)) < 0 && errno != EAGAIN) {
+        LOG_ERROR("HATA: io_uring eventfd okunamadı: %s", strerror(errno));
+    }
+
+    int last_fd = -1;
+    uint8_t tunnel_id = 0;
+    unsigned head = *cq_head_;
+
+    while (true) {
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head == tail) break;
+
+        // CQ taraması başına tek saat okuması
+        batch_time_ = std::chrono::steady_clock::now();
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            const int socket_fd = static_cast<int>(cqe.user_data);
+
+            if (socket_fd != last_fd) {
+                auto it = sockets_.find(socket_fd);
+                if (it == sockets_.end()) {
+                    LOG_ERROR("HATA: io_uring completion'ı bilinmeyen sokete ait (fd %d)", socket_fd);
+                    failed_ = true;
+                    continue;
+                }
+                last_fd = socket_fd;
+                tunnel_id = it->second;
+            }
+
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                rearm_.push_back(socket_fd); // Multishot sona erdi
+            }
+
+            if (cqe.res < 0) {
+                if (cqe.res == -ENOBUFS) {
+                    ++empty_rearms_;
+                } else {
+                    LOG_ERROR("HATA: io_uring recvmsg hatası (fd %d): %s", socket_fd, strerror(-cqe.res));
+                    failed_ = true;
+                }
+                continue;
+            }
+            if (!(cqe.flags & IORING_CQE_F_BUFFER)) continue;
+
+            const unsigned buffer_id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+            if (buffer_id >= URING_BUFFER_COUNT) {
+                LOG_ERROR("HATA: io_uring geçersiz buffer id %u döndürdü", buffer_id);
+                failed_ = true;
+                continue;
+            }
+            uint8_t* buffer = buffers_.data() + static_cast<size_t>(buffer_id) * BUFFER_SIZE;
+            used_buffers_.push_back(static_cast<uint16_t>(buffer_id));
+            empty_rearms_ = 0;
+
+            const auto* out = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+            const size_t payload_offset = sizeof(io_uring_recvmsg_out) + recv_template_.msg_namelen;
+            if (static_cast<size_t>(cqe.res) < payload_offset) continue;
+
+            ReceivedDatagram datagram;
+            datagram.data = buffer + payload_offset;
+            datagram.length = std::min<size_t>(out->payloadlen, cqe.res - payload_offset);
+            datagram.source = reinterpret_cast<const sockaddr_in*>(buffer + sizeof(io_uring_recvmsg_out));
+            datagram.tunnel_id = tunnel_id;
+            datagram.truncated = (out->flags & MSG_TRUNC) != 0;
+            datagram.segment_size = 0;
+            batch_.push_back(datagram);
+
+            if (batch_.size() == RECV_BATCH_SIZE) {
+                __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+                flush_batch();
+            }
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    flush_batch();
+
+    // Veri almadan tekrar tekrar buffer tükenmesi bildiren ring bozuk kabul edilir
+    if (empty_rearms_ > URING_MAX_EMPTY_REARMS) {
+        LOG_ERROR("HATA: io_uring buffer ring'i veri teslim etmiyor (%u ardışık ENOBUFS)", empty_rearms_);
+        failed_ = true;
+    }
+
+    // Buffer'lar iade edildikten sonra sona eren istekleri yeniden kur
+    if (!failed_) {
+        for (int socket_fd : rearm_) {
+            if (!submit_recv(socket_fd)) {
+                failed_ = true;
+                break;
+            }
+        }
+    }
+    rearm_.clear();
+    return true;
+}
@@ -0,0 +1,78 @@
+// io_uring_backend.h - NovaEngine io_uring alım backend'i (multishot recvmsg)
+#pragma once
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <linux/io_uring.h>
+#include "receive_backend.h"
+
+constexpr unsigned URING_BUFFER_COUNT = 4096;      // Provided buffer ring girdisi (2'nin kuvveti)
+constexpr unsigned URING_CQ_ENTRIES = 8192;
+constexpr uint16_t URING_BUFFER_GROUP = 0;
+constexpr unsigned URING_MAX_EMPTY_REARMS = 8;     // Arka arkaya veri getirmeyen ENOBUFS sınırı
+
+// Her tünel soketinde tek bir multishot IORING_OP_RECVMSG; kernel datagramları kayıtlı
+// buffer ring'inden seçtiği buffer'lara yazar ve completion kuyruğuna ekler. Soket başına
+// syscall yalnızca kurulumda ve multishot sona erdiğinde (ör. buffer tükenmesi) yapılır.
+// Completion'lar eventfd ile bildirilir; eventfd engine'in epoll'üne eklenir, CQ kullanıcı
+// alanından boşaltılır ve buffer'lar işlendikten sonra ring'e iade edilir.
+// liburing kullanılmaz; ring'ler doğrudan io_uring_setup/mmap ile kurulur.
+class IoUringReceiveBackend : public ReceiveBackend {
+public:
+    IoUringReceiveBackend();
+    ~IoUringReceiveBackend() override;
+
+    const char* name() const override { return "io_uring"; }
+    bool start(int epoll_fd, const std::map<int, uint8_t>& sockets) override;
+    bool arm() override;
+    bool on_readable(int fd) override;
+    bool healthy() const override { return !failed_; }
+
+private:
+    // Buffer düzeni: io_uring_recvmsg_out | sockaddr_in | payload
+    static constexpr size_t BUFFER_SIZE = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + RECV_SLOT_SIZE;
+
+    int ring_fd_;
+    int event_fd_;
+    std::map<int, uint8_t> sockets_;
+    struct msghdr recv_template_;              // Multishot recvmsg şablonu (yalnızca namelen kullanılır)
+
+    // SQ/CQ ring eşlemeleri
+    void* sq_ring_ptr_;
+    size_t sq_ring_size_;
+    void* cq_ring_ptr_;
+    size_t cq_ring_size_;
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned* cq_mask_;
+    io_uring_cqe* cqes_;
+
+    // Provided buffer ring
+    io_uring_buf_ring* buf_ring_;
+    size_t buf_ring_size_;
+    std::vector<uint8_t> buffers_;            // URING_BUFFER_COUNT x BUFFER_SIZE
+    uint16_t buf_tail_;
+    std::vector<uint16_t> used_buffers_;       // Handler sonrası iade edilecek buffer id'leri
+
+    std::vector<ReceivedDatagram> batch_;
+    std::vector<int> rearm_;                   // Multishot'ı sona eren soketler
+    std::chrono::steady_clock::time_point batch_time_;
+    unsigned empty_rearms_;
+    bool failed_;                              // Ring çalışmıyor; engine epoll'e geçmeli
+
+    bool setup_rings();
+    bool register_buffers();
+    bool submit_recv(int socket_fd);
+    void recycle_buffer(uint16_t buffer_id);
+    void publish_buffers();
+    void flush_batch();
+};
@@ -48,8 +48,9 @@ int main(int argc, char *argv[]) {
     std::cout << "========================================================" << std::endl;
     std::cout << "            Nova Camera - Görüntülü İletişim" << std::endl;
     std::cout << "========================================================" << std::endl;
-    std::cout << "Kullanım: ./nova_camera [arkadaşının_IP_adresi] [kendi_portun] [arkadaşının_portu]" << std::endl;
+    std::cout << "Kullanım: ./nova_camera [arkadaşının_IP_adresi] [kendi_portun] [arkadaşının_portu] [tünel_sayısı]" << std::endl;
     std::cout << "Örnek: ./nova_camera 192.168.1.100 5001 5001" << std::endl;
+    std::cout << "Çok yollu: ./nova_camera 192.168.1.100 5001 5001 3  (portlar 5001-5003, iki tarafta aynı sayı)" << std::endl;
     std::cout << "--------------------------------------------------------" << std::endl;
     std::cout << "ÖNEMLİ: 'arkadaşının_IP_adresi' yerine, konuştuğunuz kişinin" << std::endl;
     std::cout << "        size verdiği IP adresini (örn: 192.168.1.100 veya 85.10.11.12) yazmalısınız." << std::endl;
@@ -60,6 +61,8 @@ int main(int argc, char *argv[]) {
     if (argc >= 2) remote_ip = argv[1];
     if (argc >= 3) local_port = std::stoi(argv[2]);
     if (argc >= 4) remote_port = std::stoi(argv[3]);
+    int multipath_tunnels = 0; // 0 = tek port RTP
+    if (argc >= 5) multipath_tunnels = std::stoi(argv[4]);
     
     // IP adresinden port numarasını ayır (örn: 127.0.0.1:5001)
     size_t colon_pos = remote_ip.find(':');
@@ -85,13 +88,21 @@ int main(int argc, char *argv[]) {
         std::cerr << "HATA: Geçersiz remote port: " << remote_port << std::endl;
         return 1;
     }
+    if (multipath_tunnels < 0 || multipath_tunnels > 16 ||
+        local_port + multipath_tunnels > 65536 || remote_port + multipath_tunnels > 65536) {
+        std::cerr << "HATA: Geçersiz tünel sayısı: " << multipath_tunnels << std::endl;
+        return 1;
+    }
 
     std::cout << "Ayarlar:" << std::endl;
     std::cout << "  - Görüntü Gönderilecek IP (Arkadaşın): " << remote_ip << ":" << remote_port << std::endl;
     std::cout << "  - Görüntü Alınacak Port (Senin): " << local_ip << ":" << local_port << std::endl;
+    if (multipath_tunnels > 0) {
+        std::cout << "  - Çok Yollu Mod: " << multipath_tunnels << " tünel (portlar +0.." << multipath_tunnels - 1 << ")" << std::endl;
+    }
     std::cout << std::endl;
 
-    global_camera_ptr = std::make_unique<NovaCamera>(local_ip, local_port, remote_ip, remote_port);
+    global_camera_ptr = std::make_unique<NovaCamera>(local_ip, local_port, remote_ip, remote_port, multipath_tunnels);
 
     if (!global_camera_ptr->initialize()) {
         std::cerr << "HATA: Kamera başlatılamadı!" << std::endl;
@@ -3,6 +3,7 @@
 #include <vector>
 #include <csignal>
 #include "common/packet.hpp"
+#include "common/logger.hpp"
 #include <asio.hpp>
 
 using namespace udp_streaming;
@@ -38,31 +39,41 @@ int main(int argc, char* argv[]) {
         
         std::cout << "Test paketleri dinleniyor..." << std::endl;
         
+        PacketParser parser;
+        std::array<uint8_t, PACKET_MAX_DATAGRAM_SIZE> buffer;
         while (g_running.load()) {
-            Packet packet;
             asio::ip::udp::endpoint sender_endpoint;
             
             try {
-                size_t received = socket.receive_from(
-                    asio::buffer(&packet, sizeof(packet)), sender_endpoint);
+                size_t received = socket.receive_from(asio::buffer(buffer), sender_endpoint);
                 
                 if (received > 0) {
-                    packet.to_host_order();
-                    
-                    if (PacketValidator::is_valid(packet)) {
-                        std::cout << "Paket alındı: #" << packet.header.sequence_number 
-                                 << " (IP: " << sender_endpoint.address().to_string() 
-                                 << ":" << sender_endpoint.port() << ")" << std::endl;
-                        
-                        if (PacketValidator::is_heartbeat_packet(packet)) {
-                            std::cout << "  Tür: Heartbeat" << std::endl;
-                        } else if (PacketValidator::is_video_packet(packet)) {
-                            std::cout << "  Tür: Video Data" << std::endl;
-                            std::cout << "  Frame ID: " << packet.header.frame_id << std::endl;
-                            std::cout << "  NAL Unit ID: " << packet.header.nal_unit_id << std::endl;
+                    // Yalnızca header alanları okunur, payload kopyalanmaz
+                    const PacketView view(buffer.data(), received);
+                    uint32_t sequence;
+                    uint64_t frame_timestamp;
+                    if (parser.accept(view, sequence, frame_timestamp)) {
+                        if (PacketValidator::is_heartbeat_packet(view)) {
+                            UDP_LOG_INFO("Paket alındı: #%u (IP: %s:%u, v%u, %zu byte)\n  Tür: Heartbeat",
+                                         sequence,
+                                         sender_endpoint.address().to_string().c_str(),
+                                         sender_endpoint.port(),
+                                         static_cast<unsigned>(view.version()), received);
+                        } else if (PacketValidator::is_video_packet(view)) {
+                            UDP_LOG_INFO("Paket alındı: #%u (IP: %s:%u)\n  Tür: Video Data\n"
+                                         "  Frame ID: %u\n  NAL Unit ID: %u",
+                                         sequence,
+                                         sender_endpoint.address().to_string().c_str(),
+                                         sender_endpoint.port(),
+                                         view.frame_id(), view.nal_unit_id());
+                        } else {
+                            UDP_LOG_INFO("Paket alındı: #%u (IP: %s:%u)",
+                                         sequence,
+                                         sender_endpoint.address().to_string().c_str(),
+                                         sender_endpoint.port());
                         }
                     } else {
-                        std::cerr << "Geçersiz paket alındı!" << std::endl;
+                        UDP_LOG_WARN("Geçersiz paket alındı!");
                     }
                 }
             } catch (const std::exception& e) {
@@ -5,6 +5,7 @@
 #include <thread>
 #include <chrono>
 #include "common/packet.hpp"
+#include "common/logger.hpp"
 #include <asio.hpp>
 
 using namespace udp_streaming;
@@ -26,17 +27,19 @@ int main(int argc, char* argv[]) {
     std::cout << "========================================================" << std::endl;
     
     if (argc < 2) {
-        std::cout << "Kullanım: " << argv[0] << " <hedef_ip> [port]" << std::endl;
-        std::cout << "Örnek: " << argv[0] << " 192.168.1.5 5000" << std::endl;
+        std::cout << "Kullanım: " << argv[0] << " <hedef_ip> [port] [kablo_sürümü: 1|2]" << std::endl;
+        std::cout << "Örnek: " << argv[0] << " 192.168.1.5 5000 2" << std::endl;
         return 1;
     }
     
     std::string remote_ip = argv[1];
     uint16_t port = (argc > 2) ? static_cast<uint16_t>(std::stoi(argv[2])) : 5000;
+    WireVersion version = (argc > 3 && std::stoi(argv[3]) >= 2) ? WireVersion::V2 : WireVersion::V1;
     
     std::cout << "Ayarlar:" << std::endl;
     std::cout << "  Hedef IP: " << remote_ip << std::endl;
     std::cout << "  Port: " << port << std::endl;
+    std::cout << "  Kablo sürümü: v" << static_cast<int>(version) << std::endl;
     std::cout << "--------------------------------------------------------" << std::endl;
     
     try {
@@ -50,21 +53,21 @@ int main(int argc, char* argv[]) {
         std::cout << "Test paketleri gönderiliyor..." << std::endl;
         
         uint32_t sequence_number = 0;
+        std::array<uint8_t, PACKET_MAX_DATAGRAM_SIZE> buffer;
         while (g_running.load()) {
             // Test paketi oluştur
             auto packet = PacketBuilder::create_heartbeat_packet(sequence_number);
             
-            // Network byte order'a çevir
-            packet.to_network_order();
+            // Kablo formatına çevir
+            const size_t size = PacketSerializer::serialize(packet, version, buffer.data(), buffer.size());
             
             // Gönder
-            size_t sent = socket.send_to(
-                asio::buffer(&packet, packet.get_total_size()), endpoint);
+            size_t sent = socket.send_to(asio::buffer(buffer.data(), size), endpoint);
             
-            if (sent == packet.get_total_size()) {
-                std::cout << "Paket gönderildi: #" << sequence_number << std::endl;
+            if (sent == size) {
+                UDP_LOG_INFO("Paket gönderildi: #%u", sequence_number);
             } else {
-                std::cerr << "Paket gönderilemedi!" << std::endl;
+                UDP_LOG_WARN("Paket gönderilemedi!");
             }
             
             sequence_number++;
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define UDP_CRC32C_X86 1
+#endif
+
+namespace udp_streaming {
+
+// CRC32C (Castagnoli, iSCSI/ext4 polinomu). Ara durum ters çevrilmiş tutulur:
+// crc = CRC32C_INIT ile başla, parçaları crc32c_extend* ile ekle, sonucu crc32c_finish ile al.
+// x86-64'te SSE4.2 crc32 komutu (CPU desteği çalışma zamanında bir kez kontrol edilir; komutun
+// gecikmesini gizlemek için üç bağımsız blok paralel işlenip birleştirilir), diğer durumlarda
+// slicing-by-8 tablo kullanılır.
+constexpr uint32_t CRC32C_INIT = 0xFFFFFFFFu;
+constexpr uint32_t CRC32C_POLY = 0x82F63B78u; // Yansıtılmış
+
+inline uint32_t crc32c_finish(uint32_t crc) {
+    return ~crc;
+}
+
+namespace detail {
+
+using Crc32cTable = std::array<std::array<uint32_t, 256>, 8>;
+
+inline const Crc32cTable& crc32c_table() {
+    static const Crc32cTable table = [] {
+        Crc32cTable t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+            }
+            t[0][i] = crc;
+        }
+        for (size_t slice = 1; slice < 8; ++slice) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                t[slice][i] = (t[slice - 1][i] >> 8) ^ t[0][t[slice - 1][i] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+// CRC durumunu n sıfır byte ilerleten doğrusal operatör (byte başına bir tablo)
+using Crc32cShiftTable = std::array<std::array<uint32_t, 256>, 4>;
+
+inline Crc32cShiftTable make_crc32c_shift_table(size_t zero_bytes) {
+    const auto& base = crc32c_table()[0];
+    Crc32cShiftTable shift{};
+    for (size_t position = 0; position < 4; ++position) {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            uint32_t crc = byte << (8 * position);
+            for (size_t i = 0; i < zero_bytes; ++i) {
+                crc = (crc >> 8) ^ base[crc & 0xFF];
+            }
+            shift[position][byte] = crc;
+        }
+    }
+    return shift;
+}
+
+inline uint32_t crc32c_shift(const Crc32cShiftTable& shift, uint32_t crc) {
+    return shift[0][crc & 0xFF] ^ shift[1][(crc >> 8) & 0xFF] ^
+           shift[2][(crc >> 16) & 0xFF] ^ shift[3][crc >> 24];
+}
+
+// Tablo yolu; dst != nullptr ise okunan byte'lar aynı geçişte dst'ye yazılır
+inline uint32_t crc32c_software(uint32_t crc, uint8_t* dst, const uint8_t* src, size_t size) {
+    const Crc32cTable& t = crc32c_table();
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, src, sizeof(word));
+        if (dst) {
+            std::memcpy(dst, &word, sizeof(word));
+            dst += 8;
+        }
+        // Little-endian: ilk byte en düşük anlamlı
+        const uint32_t low = static_cast<uint32_t>(word) ^ crc;
+        const uint32_t high = static_cast<uint32_t>(word >> 32);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        src += 8;
+        size -= 8;
+    }
+    while (size--) {
+        const uint8_t byte = *src++;
+        if (dst) {
+            *dst++ = byte;
+        }
+        crc = (crc >> 8) ^ t[0][(crc ^ byte) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef UDP_CRC32C_X86
+constexpr size_t CRC32C_STRIDE = 128; // Paralel blok boyutu (1200 byte'lık payload ~3 tur)
+
+__attribute__((target("sse4.2")))
+inline uint32_t crc32c_hardware(uint32_t crc, uint8_t* dst, const uint8_t* src, size_t size) {
+    static const Crc32cShiftTable shift_one = make_crc32c_shift_table(CRC32C_STRIDE);
+    static const Crc32cShiftTable shift_two = make_crc32c_shift_table(2 * CRC32C_STRIDE);
+
+    // crc(A|B|C) = shift_2(crc(A)) ^ shift_1(crc0(B)) ^ crc0(C); crc0 sıfır durumdan başlar
+    while (size >= 3 * CRC32C_STRIDE) {
+        uint64_t crc_a = crc, crc_b = 0, crc_c = 0;
+        for (size_t i = 0; i < CRC32C_STRIDE; i += 8) {
+            uint64_t a, b, c;
+            std::memcpy(&a, src + i, sizeof(a));
+            std::memcpy(&b, src + CRC32C_STRIDE + i, sizeof(b));
+            std::memcpy(&c, src + 2 * CRC32C_STRIDE + i, sizeof(c));
+            if (dst) {
+                std::memcpy(dst + i, &a, sizeof(a));
+                std::memcpy(dst + CRC32C_STRIDE + i, &b, sizeof(b));
+                std::memcpy(dst + 2 * CRC32C_STRIDE + i, &c, sizeof(c));
+            }
+            crc_a = _mm_crc32_u64(crc_a, a);
+            crc_b = _mm_crc32_u64(crc_b, b);
+            crc_c = _mm_crc32_u64(crc_c, c);
+        }
+        crc = crc32c_shift(shift_two, static_cast<uint32_t>(crc_a)) ^
+              crc32c_shift(shift_one, static_cast<uint32_t>(crc_b)) ^ static_cast<uint32_t>(crc_c);
+        src += 3 * CRC32C_STRIDE;
+        if (dst) {
+            dst += 3 * CRC32C_STRIDE;
+        }
+        size -= 3 * CRC32C_STRIDE;
+    }
+
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, src, sizeof(word));
+        if (dst) {
+            std::memcpy(dst, &word, sizeof(word));
+            dst += 8;
+        }
+        crc64 = _mm_crc32_u64(crc64, word);
+        src += 8;
+        size -= 8;
+    }
+    uint32_t crc32 = static_cast<uint32_t>(crc64);
+    while (size--) {
+        const uint8_t byte = *src++;
+        if (dst) {
+            *dst++ = byte;
+        }
+        crc32 = _mm_crc32_u8(crc32, byte);
+    }
+    return crc32;
+}
+
+inline bool crc32c_hardware_supported() {
+#ifdef __SSE4_2__
+    return true; // -msse4.2 / -march=native ile derlendi
+#else
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#endif
+}
+#endif
+
+inline uint32_t crc32c_dispatch(uint32_t crc, uint8_t* dst, const uint8_t* src, size_t size) {
+#ifdef UDP_CRC32C_X86
+    if (crc32c_hardware_supported()) {
+        return crc32c_hardware(crc, dst, src, size);
+    }
+#endif
+    return crc32c_software(crc, dst, src, size);
+}
+
+} // namespace detail
+
+// Veriyi CRC'ye ekle
+inline uint32_t crc32c_extend(uint32_t crc, const uint8_t* data, size_t size) {
+    return detail::crc32c_dispatch(crc, nullptr, data, size);
+}
+
+// src'yi dst'ye kopyalarken CRC'ye ekle (tek geçiş, ayrı memcpy yok)
+inline uint32_t crc32c_extend_copy(uint32_t crc, uint8_t* dst, const uint8_t* src, size_t size) {
+    return detail::crc32c_dispatch(crc, dst, src, size);
+}
+
+// Tek parça için tam CRC32C
+inline uint32_t crc32c(const uint8_t* data, size_t size) {
+    return crc32c_finish(crc32c_extend(CRC32C_INIT, data, size));
+}
+
+} // namespace udp_streaming
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+
+namespace udp_streaming {
+
+// Log seviyeleri (derleme zamanı filtresi için sayısal)
+#define UDP_LOG_LEVEL_DEBUG 0
+#define UDP_LOG_LEVEL_INFO  1
+#define UDP_LOG_LEVEL_WARN  2
+#define UDP_LOG_LEVEL_ERROR 3
+#define UDP_LOG_LEVEL_OFF   4
+
+// Bu seviyenin altındaki çağrılar derlenmez (ör. -DUDP_LOG_LEVEL=0 ile paket logları açılır)
+#ifndef UDP_LOG_LEVEL
+#define UDP_LOG_LEVEL UDP_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t {
+    DEBUG = UDP_LOG_LEVEL_DEBUG,
+    INFO = UDP_LOG_LEVEL_INFO,
+    WARN = UDP_LOG_LEVEL_WARN,
+    ERROR = UDP_LOG_LEVEL_ERROR
+};
+
+constexpr size_t LOG_RECORD_SIZE = 256;     // Kayıt başına sabit boyut (uzun mesajlar kesilir)
+constexpr size_t LOG_RING_CAPACITY = 1024;  // Thread başına kayıt sayısı (2'nin kuvveti)
+
+// Asenkron logger - her thread kendi lock-free halkasına yazar, tek bir drain thread'i
+// halkaları toplu halde stdout (DEBUG/INFO) veya stderr (WARN/ERROR) üzerine boşaltır.
+// Paket yolunda kilit, allocation veya sistem çağrısı yoktur; halka doluysa kayıt düşürülür.
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    bool enabled(LogLevel level) const {
+        return static_cast<uint8_t>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+    void set_level(LogLevel level) { min_level_.store(static_cast<uint8_t>(level)); }
+
+    __attribute__((format(printf, 3, 4)))
+    void log(LogLevel level, const char* format, ...) {
+        Ring& ring = local_ring();
+        const size_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail - ring.head.load(std::memory_order_acquire) == LOG_RING_CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Record& record = ring.records[tail & (LOG_RING_CAPACITY - 1)];
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(record.text, LOG_RECORD_SIZE, format, args);
+        va_end(args);
+        record.level = level;
+        record.length = static_cast<uint16_t>(std::clamp<int>(written, 0, LOG_RECORD_SIZE - 1));
+
+        ring.tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // Bekleyen tüm kayıtları yaz
+    void flush() { drain_once(); }
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+    ~Logger() {
+        running_ = false;
+        if (drain_thread_.joinable()) {
+            drain_thread_.join();
+        }
+        drain_once();
+    }
+
+private:
+    struct Record {
+        LogLevel level;
+        uint16_t length;
+        char text[LOG_RECORD_SIZE];
+    };
+
+    struct Ring {
+        std::vector<Record> records = std::vector<Record>(LOG_RING_CAPACITY);
+        alignas(64) std::atomic<size_t> head{0}; // Drain thread konumu
+        alignas(64) std::atomic<size_t> tail{0}; // Sahip thread konumu
+        std::atomic<bool> orphaned{false};       // Sahip thread sonlandı
+    };
+
+    struct RingHandle {
+        std::shared_ptr<Ring> ring;
+        ~RingHandle() {
+            if (ring) ring->orphaned.store(true, std::memory_order_release);
+        }
+    };
+
+    Logger()
+        : min_level_(std::min(UDP_LOG_LEVEL, UDP_LOG_LEVEL_ERROR)), dropped_(0),
+          reported_dropped_(0), running_(true) {
+        drain_thread_ = std::thread([this]() {
+            while (running_.load(std::memory_order_relaxed)) {
+                if (drain_once() == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+
+    Ring& local_ring() {
+        thread_local RingHandle handle;
+        if (!handle.ring) {
+            handle.ring = std::make_shared<Ring>();
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    size_t drain_once() {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+
+        size_t drained = 0;
+        bool wrote_out = false;
+        bool wrote_err = false;
+
+        for (auto it = rings_.begin(); it != rings_.end();) {
+            Ring& ring = **it;
+            const bool orphaned = ring.orphaned.load(std::memory_order_acquire);
+            size_t head = ring.head.load(std::memory_order_relaxed);
+            const size_t tail = ring.tail.load(std::memory_order_acquire);
+
+            for (; head != tail; ++head) {
+                const Record& record = ring.records[head & (LOG_RING_CAPACITY - 1)];
+                const bool is_error = record.level >= LogLevel::WARN;
+                FILE* out = is_error ? stderr : stdout;
+                fwrite(record.text, 1, record.length, out);
+                fputc('\n', out);
+                wrote_err |= is_error;
+                wrote_out |= !is_error;
+                drained++;
+            }
+            ring.head.store(head, std::memory_order_release);
+
+            if (orphaned) {
+                it = rings_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped_) {
+            fprintf(stderr, "%llu log kaydı düşürüldü (halka dolu)\n",
+                    static_cast<unsigned long long>(dropped - reported_dropped_));
+            reported_dropped_ = dropped;
+            wrote_err = true;
+        }
+
+        // Her kayıt yerine parti başına bir flush
+        if (wrote_out) fflush(stdout);
+        if (wrote_err) fflush(stderr);
+        return drained;
+    }
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::atomic<uint8_t> min_level_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t reported_dropped_;
+    std::atomic<bool> running_;
+    std::thread drain_thread_;
+};
+
+} // namespace udp_streaming
+
+#define UDP_LOG_AT(level, ...) \
+    do { \
+        ::udp_streaming::Logger& udp_logger_ = ::udp_streaming::Logger::instance(); \
+        if (udp_logger_.enabled(level)) udp_logger_.log(level, __VA_ARGS__); \
+    } while (0)
+
+#if UDP_LOG_LEVEL <= UDP_LOG_LEVEL_DEBUG
+#define UDP_LOG_DEBUG(...) UDP_LOG_AT(::udp_streaming::LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define UDP_LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if UDP_LOG_LEVEL <= UDP_LOG_LEVEL_INFO
+#define UDP_LOG_INFO(...) UDP_LOG_AT(::udp_streaming::LogLevel::INFO, __VA_ARGS__)
+#else
+#define UDP_LOG_INFO(...) do {} while (0)
+#endif
+
+#if UDP_LOG_LEVEL <= UDP_LOG_LEVEL_WARN
+#define UDP_LOG_WARN(...) UDP_LOG_AT(::udp_streaming::LogLevel::WARN, __VA_ARGS__)
+#else
+#define UDP_LOG_WARN(...) do {} while (0)
+#endif
+
+#if UDP_LOG_LEVEL <= UDP_LOG_LEVEL_ERROR
+#define UDP_LOG_ERROR(...) UDP_LOG_AT(::udp_streaming::LogLevel::ERROR, __VA_ARGS__)
+#else
+#define UDP_LOG_ERROR(...) do {} while (0)
+#endif
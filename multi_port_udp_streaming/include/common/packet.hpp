@@ -1,18 +1,58 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <cstring>
 #include <array>
 #include <chrono>
+#include <algorithm>
 #include <arpa/inet.h> // For htonl, ntohl
 #include <endian.h>    // For htobe64, be64toh
+#include "crc32c.hpp"
 
 namespace udp_streaming {
 
+// Kablo formatı sürümleri. Alıcı her ikisini de ilk byte'tan tanır (v1: 0xDE, v2: 0xA2);
+// gönderici v1 ile başlar, alıcının CONTROL/CAPABILITY teklifini alınca v2'ye geçer.
+// Anlaşılan sürüm bir kiradır: alıcı duyduğu her göndericiye teklifini periyodik olarak
+// yineler, teklif kesilirse (alıcı eski sürümle yeniden başladı) gönderici v1'e döner.
+enum class WireVersion : uint8_t {
+    V1 = 1, // 36 byte, mutlak 64-bit timestamp, 32-bit magic
+    V2 = 2  // 16 byte, 16-bit sıra no, frame'e göre timestamp farkı
+};
+constexpr WireVersion WIRE_VERSION_MAX = WireVersion::V2;
+constexpr auto CAPABILITY_OFFER_INTERVAL = std::chrono::seconds(1); // Alıcı, gönderici başına
+constexpr auto WIRE_VERSION_LEASE = std::chrono::seconds(3);        // Teklifsiz bu süre sonra v1
+
+// v2 bütünlük kontrolü. CRC32C header + payload'ı kapsar ve payload kopyalanırken aynı
+// geçişte hesaplanır; UDP_CHECKSUM'da CRC gönderilmez / doğrulanmaz (yalnızca UDP checksum).
+// v1 eski alıcılarla uyum için header byte toplamını kullanmaya devam eder.
+enum class IntegrityMode : uint8_t {
+    CRC32C,
+    UDP_CHECKSUM
+};
+
 // Packet boyutu sabitleri
-constexpr size_t PACKET_HEADER_SIZE = 32;
-constexpr size_t PACKET_PAYLOAD_SIZE = 1200;
+constexpr size_t PACKET_HEADER_SIZE_V1 = 36;
+constexpr size_t PACKET_HEADER_SIZE_V2 = 16;
+constexpr size_t PACKET_FRAME_TIMESTAMP_SIZE = 8; // v2: frame'in mutlak timestamp'i (flag ile)
+constexpr size_t PACKET_CRC32C_SIZE = 4;          // v2: payload'dan sonra CRC32C (flag ile)
+// v2 timestamp farkı 8 µs biriminde taşınır (~524 ms, encoder gecikmesi sığar); aralığı
+// aşan fark PACKET_TIMESTAMP_DELTA_SATURATED olarak gider, alıcı sayar
+constexpr uint64_t PACKET_TIMESTAMP_DELTA_UNIT_US = 8;
+constexpr uint16_t PACKET_TIMESTAMP_DELTA_SATURATED = 0xFFFF;
+constexpr size_t PACKET_HEADER_SIZE = PACKET_HEADER_SIZE_V1;
+constexpr size_t PACKET_PAYLOAD_SIZE = 1200;   // v1 payload'ı
 constexpr size_t PACKET_TOTAL_SIZE = PACKET_HEADER_SIZE + PACKET_PAYLOAD_SIZE;
+// Datagram bütçesi sürümden bağımsız; v2'de küçülen header payload'a kalır
+constexpr size_t PACKET_MAX_DATAGRAM_SIZE = PACKET_TOTAL_SIZE;
+constexpr size_t PACKET_MAX_PAYLOAD_SIZE =
+    PACKET_MAX_DATAGRAM_SIZE - PACKET_HEADER_SIZE_V2 - PACKET_FRAME_TIMESTAMP_SIZE - PACKET_CRC32C_SIZE;
+
+// Sürüme göre paket başına payload (v2'de frame timestamp'i ve CRC taşınabileceği varsayılır)
+constexpr size_t max_payload_size(WireVersion version) {
+    return version == WireVersion::V1 ? PACKET_PAYLOAD_SIZE : PACKET_MAX_PAYLOAD_SIZE;
+}
 
 // Paket türleri
 enum class PacketType : uint8_t {
@@ -24,6 +64,11 @@ enum class PacketType : uint8_t {
     FRAME_END = 0x06
 };
 
+// CONTROL paketlerinin payload'ındaki ilk byte
+enum class ControlType : uint8_t {
+    CAPABILITY = 0x01 // Alıcının desteklediği en yüksek kablo sürümü
+};
+
 // Paket başlığı - Network byte order (big-endian) için optimize edilmiş
 #pragma pack(push, 1) // 1-byte alignment
 struct PacketHeader {
@@ -67,12 +112,14 @@ struct PacketHeader {
         nal_unit_id = ntohl(nal_unit_id);
     }
 
-    // Checksum hesapla
+    // Checksum hesapla (ilk 32 byte, checksum alanı 0 sayılır - eski göndericilerle aynı değer)
     uint32_t calculate_checksum() const {
         uint32_t sum = 0;
         const uint8_t* data = reinterpret_cast<const uint8_t*>(this);
+        const size_t checksum_offset = offsetof(PacketHeader, checksum);
 
         for (size_t i = 0; i < sizeof(PacketHeader) - sizeof(checksum); ++i) {
+            if (i - checksum_offset < sizeof(checksum)) continue;
             sum += data[i];
         }
 
@@ -89,14 +136,59 @@ struct PacketHeader {
         checksum = calculate_checksum();
     }
 };
+
+// Kompakt başlık (v2) - big-endian. Mutlak frame timestamp'i yalnızca
+// PACKET_FLAG_FRAME_TIMESTAMP taşıyan paketlerde (frame'in ilk paketi, heartbeat, control)
+// header'dan hemen sonra 8 byte olarak gelir; diğerleri yalnızca farkı taşır.
+constexpr uint8_t PACKET_V2_MAGIC_VERSION = 0xA0 | static_cast<uint8_t>(WireVersion::V2);
+constexpr uint8_t PACKET_FLAG_FRAME_TIMESTAMP = 0x01;
+constexpr uint8_t PACKET_FLAG_CRC32C = 0x02; // Payload'dan sonra big-endian CRC32C
+
+struct PacketHeaderV2 {
+    uint8_t magic_version;    // Üst 4 bit magic (0xA), alt 4 bit sürüm
+    uint8_t packet_type;      // PacketType enum değeri
+    uint8_t port_id;          // Hangi porttan gönderildiği
+    uint8_t flags;            // PACKET_FLAG_*
+    uint16_t sequence_number; // Sıra numarasının alt 16 biti (alıcı genişletir)
+    uint16_t payload_size;    // Payload boyutu
+    uint32_t frame_id;        // Frame ID
+    uint16_t nal_unit_id;     // Frame içindeki paket indeksi
+    uint16_t timestamp_delta; // Frame timestamp'inden fark (8 µs birimi, 0xFFFF = doydu)
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PacketHeader) == PACKET_HEADER_SIZE_V1, "v1 header boyutu");
+static_assert(sizeof(PacketHeaderV2) == PACKET_HEADER_SIZE_V2, "v2 header boyutu");
+
+#pragma pack(push, 1)
+struct CapabilityPayload {
+    uint8_t control_type;     // ControlType::CAPABILITY
+    uint8_t max_wire_version; // Desteklenen en yüksek WireVersion
+};
 #pragma pack(pop)
 
+// 16-bit sıra numarasını en yakın 32-bit değere genişlet (reference: son genişletilen)
+inline uint32_t extend_sequence_number(uint16_t low, uint32_t reference) {
+    uint32_t candidate = (reference & 0xFFFF0000u) | low;
+    const int32_t diff = static_cast<int32_t>(candidate - reference);
+    if (diff > 0x8000) {
+        candidate -= 0x10000;
+    } else if (diff < -0x8000) {
+        candidate += 0x10000;
+    }
+    return candidate;
+}
+
 // Tam paket yapısı
+// Bellekteki temsil sürümden bağımsızdır (header host byte order'da, v1 alanlarıyla);
+// kabloya PacketSerializer yazar, PacketParser okur.
 struct Packet {
     PacketHeader header;
-    std::array<uint8_t, PACKET_PAYLOAD_SIZE> payload;
+    uint64_t frame_timestamp;                 // Frame'in timestamp'i (µs, v2 farkın tabanı)
+    uint8_t wire_version;                     // Alındığı / gönderileceği sürüm
+    std::array<uint8_t, PACKET_MAX_PAYLOAD_SIZE> payload;
 
-    Packet() : header(), payload() {
+    Packet() : header(), frame_timestamp(0), wire_version(static_cast<uint8_t>(WireVersion::V1)), payload() {
         payload.fill(0);
     }
 
@@ -135,36 +227,394 @@ struct Packet {
         return payload.data();
     }
 
-    // Paket boyutu
+    // Paket boyutu (v1 kablo boyutu; sürüme göre boyut için PacketSerializer::wire_size)
     size_t get_total_size() const {
         return PACKET_HEADER_SIZE + header.payload_size;
     }
 };
 
+// Packet -> kablo formatı
+class PacketSerializer {
+public:
+    // Header + timestamp uzantısının sürümden bağımsız üst sınırı (header tamponları için)
+    static constexpr size_t MAX_HEADER_SIZE = PACKET_HEADER_SIZE_V1;
+
+    static bool carries_frame_timestamp(const PacketHeader& header) {
+        return header.nal_unit_id == 0 ||
+               header.packet_type != static_cast<uint8_t>(PacketType::VIDEO_DATA);
+    }
+
+    static bool carries_frame_timestamp(const Packet& packet) {
+        return carries_frame_timestamp(packet.header);
+    }
+
+    // Payload'dan önce gelen byte sayısı (v2'de timestamp uzantısı dahil)
+    static size_t header_size(const PacketHeader& header, WireVersion version) {
+        if (version == WireVersion::V1) {
+            return PACKET_HEADER_SIZE_V1;
+        }
+        return PACKET_HEADER_SIZE_V2 + (carries_frame_timestamp(header) ? PACKET_FRAME_TIMESTAMP_SIZE : 0);
+    }
+
+    static size_t wire_size(const Packet& packet, WireVersion version,
+                            IntegrityMode integrity = IntegrityMode::CRC32C) {
+        const size_t trailer = version == WireVersion::V2 && integrity == IntegrityMode::CRC32C ? PACKET_CRC32C_SIZE : 0;
+        return header_size(packet.header, version) + packet.header.payload_size + trailer;
+    }
+
+    // Yalnızca header'ı (ve v2 timestamp uzantısını) yazar; payload ayrı bir buffer'dan
+    // gönderilebilir (scatter-gather). header.payload_size dolu olmalı. Yazılan byte sayısını
+    // döndürür (kapasite yetmezse veya payload sürüme sığmazsa 0).
+    static size_t serialize_header(const PacketHeader& header, uint64_t frame_timestamp, WireVersion version,
+                                   uint8_t* out, size_t capacity, IntegrityMode integrity = IntegrityMode::CRC32C) {
+        const size_t size = header_size(header, version);
+        if (size > capacity || header.payload_size > max_payload_size(version)) {
+            return 0;
+        }
+
+        if (version == WireVersion::V1) {
+            PacketHeader wire = header;
+            wire.magic = 0xDEADBEEF;
+            wire.update_checksum();
+            wire.to_network_order();
+            std::memcpy(out, &wire, sizeof(wire));
+            return size;
+        }
+
+        const bool has_timestamp = carries_frame_timestamp(header);
+        const uint64_t delta = header.timestamp > frame_timestamp ? header.timestamp - frame_timestamp : 0;
+        PacketHeaderV2 wire;
+        wire.magic_version = PACKET_V2_MAGIC_VERSION;
+        wire.packet_type = header.packet_type;
+        wire.port_id = header.port_id;
+        wire.flags = (has_timestamp ? PACKET_FLAG_FRAME_TIMESTAMP : 0) |
+                     (integrity == IntegrityMode::CRC32C ? PACKET_FLAG_CRC32C : 0);
+        wire.sequence_number = htons(static_cast<uint16_t>(header.sequence_number));
+        wire.payload_size = htons(header.payload_size);
+        wire.frame_id = htonl(header.frame_id);
+        wire.nal_unit_id = htons(static_cast<uint16_t>(header.nal_unit_id));
+        wire.timestamp_delta = htons(static_cast<uint16_t>(std::min<uint64_t>(
+            delta / PACKET_TIMESTAMP_DELTA_UNIT_US, PACKET_TIMESTAMP_DELTA_SATURATED)));
+        std::memcpy(out, &wire, sizeof(wire));
+        if (has_timestamp) {
+            const uint64_t frame_timestamp_be = htobe64(frame_timestamp);
+            std::memcpy(out + sizeof(wire), &frame_timestamp_be, sizeof(frame_timestamp_be));
+        }
+        return size;
+    }
+
+    // serialize_header çıktısı + payload için v2 CRC32C trailer'ı (network byte order,
+    // payload'ın ardından olduğu gibi gönderilir). Payload yalnızca okunur.
+    static uint32_t crc_trailer(const uint8_t* header, size_t header_size, const uint8_t* payload,
+                                size_t payload_size) {
+        const uint32_t crc = crc32c_extend(crc32c_extend(CRC32C_INIT, header, header_size), payload, payload_size);
+        return htonl(crc32c_finish(crc));
+    }
+
+    // Tek buffer'a tam datagram; out'a yazılan byte sayısını döndürür (hata durumunda 0)
+    static size_t serialize(const Packet& packet, WireVersion version, uint8_t* out, size_t capacity,
+                            IntegrityMode integrity = IntegrityMode::CRC32C) {
+        const size_t size = wire_size(packet, version, integrity);
+        if (size > capacity) {
+            return 0;
+        }
+        const size_t offset = serialize_header(packet.header, packet.frame_timestamp, version, out, capacity,
+                                               integrity);
+        if (offset == 0) {
+            return 0;
+        }
+
+        const uint16_t payload_size = packet.header.payload_size;
+        if (version == WireVersion::V2 && integrity == IntegrityMode::CRC32C) {
+            // CRC kopyalama sırasında hesaplanır (payload ikinci kez okunmaz)
+            uint32_t crc = crc32c_extend(CRC32C_INIT, out, offset);
+            crc = crc32c_extend_copy(crc, out + offset, packet.payload.data(), payload_size);
+            const uint32_t crc_be = htonl(crc32c_finish(crc));
+            std::memcpy(out + offset + payload_size, &crc_be, sizeof(crc_be));
+            return size;
+        }
+        std::memcpy(out + offset, packet.payload.data(), payload_size);
+        return size;
+    }
+};
+
+// Payload'a sahiplik almadan bakış (std::span yerine, C++17)
+struct PayloadSpan {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+// Alım buffer'ı üzerinde sahiplik almayan paket görünümü. Kurulumda yalnızca sürüm ve
+// boyut düzeni kontrol edilir; header alanları istendiğinde network byte order'dan okunur,
+// payload kopyalanmadan span olarak verilir. Buffer görünümden uzun yaşamalıdır.
+class PacketView {
+public:
+    PacketView(const uint8_t* data, size_t size)
+        : data_(data), size_(size), version_(WireVersion::V1), payload_offset_(0), valid_(false) {
+        if (size == 0) {
+            return;
+        }
+        if (data[0] == PACKET_V2_MAGIC_VERSION) {
+            if (size < PACKET_HEADER_SIZE_V2) {
+                return;
+            }
+            version_ = WireVersion::V2;
+            payload_offset_ = PACKET_HEADER_SIZE_V2 + (has_frame_timestamp() ? PACKET_FRAME_TIMESTAMP_SIZE : 0);
+            // Boyut tam eşleşmeli: CRC flag'i bozulup kontrol atlatılırsa artan 4 byte yakalanır
+            const size_t trailer = has_crc() ? PACKET_CRC32C_SIZE : 0;
+            valid_ = payload_size() <= PACKET_MAX_PAYLOAD_SIZE && size == payload_offset_ + payload_size() + trailer;
+        } else {
+            if (size < PACKET_HEADER_SIZE_V1) {
+                return;
+            }
+            payload_offset_ = PACKET_HEADER_SIZE_V1;
+            valid_ = read<uint32_t>(offsetof(PacketHeader, magic)) == htonl(0xDEADBEEF) &&
+                     payload_size() <= std::min(size - PACKET_HEADER_SIZE_V1, PACKET_PAYLOAD_SIZE);
+        }
+    }
+
+    // Düzen geçerli mi (sürüm, boyutlar, v1 magic). Bütünlük verify() ile kontrol edilir.
+    bool is_valid() const { return valid_; }
+    WireVersion version() const { return version_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    uint8_t packet_type() const {
+        return data_[is_v2() ? offsetof(PacketHeaderV2, packet_type) : offsetof(PacketHeader, packet_type)];
+    }
+    uint8_t port_id() const {
+        return data_[is_v2() ? offsetof(PacketHeaderV2, port_id) : offsetof(PacketHeader, port_id)];
+    }
+    // v2'de yalnızca alt 16 bit (genişletme PacketParser::accept'te)
+    uint32_t sequence_number() const {
+        return is_v2() ? ntohs(read<uint16_t>(offsetof(PacketHeaderV2, sequence_number)))
+                       : ntohl(read<uint32_t>(offsetof(PacketHeader, sequence_number)));
+    }
+    uint16_t payload_size() const {
+        return ntohs(read<uint16_t>(is_v2() ? offsetof(PacketHeaderV2, payload_size)
+                                            : offsetof(PacketHeader, payload_size)));
+    }
+    uint32_t frame_id() const {
+        return ntohl(read<uint32_t>(is_v2() ? offsetof(PacketHeaderV2, frame_id) : offsetof(PacketHeader, frame_id)));
+    }
+    uint32_t nal_unit_id() const {
+        return is_v2() ? ntohs(read<uint16_t>(offsetof(PacketHeaderV2, nal_unit_id)))
+                       : ntohl(read<uint32_t>(offsetof(PacketHeader, nal_unit_id)));
+    }
+    bool has_frame_timestamp() const {
+        return !is_v2() || (data_[offsetof(PacketHeaderV2, flags)] & PACKET_FLAG_FRAME_TIMESTAMP);
+    }
+    // v1: paketin mutlak timestamp'i; v2: flag'liyse frame timestamp'i, değilse 0
+    uint64_t frame_timestamp() const {
+        if (!is_v2()) {
+            return be64toh(read<uint64_t>(offsetof(PacketHeader, timestamp)));
+        }
+        return has_frame_timestamp() ? be64toh(read<uint64_t>(PACKET_HEADER_SIZE_V2)) : 0;
+    }
+    // Paket zamanının frame timestamp'inden farkı (µs, v1'de 0). Doymuşsa aralığın sonu
+    // döner, gerçek fark daha büyüktür.
+    uint64_t timestamp_delta_us() const {
+        return static_cast<uint64_t>(timestamp_delta()) * PACKET_TIMESTAMP_DELTA_UNIT_US;
+    }
+    bool timestamp_delta_saturated() const {
+        return timestamp_delta() == PACKET_TIMESTAMP_DELTA_SATURATED;
+    }
+    bool has_crc() const {
+        return is_v2() && (data_[offsetof(PacketHeaderV2, flags)] & PACKET_FLAG_CRC32C);
+    }
+    PayloadSpan payload() const {
+        return PayloadSpan{data_ + payload_offset_, valid_ ? payload_size() : size_t(0)};
+    }
+
+    // Bütünlük kontrolü: v1 header checksum'ı, v2 CRC32C (varsa ve mode CRC32C ise).
+    // payload_dst verilirse payload doğrulamayla aynı geçişte oraya kopyalanır (nihai hedef).
+    bool verify(IntegrityMode mode, uint8_t* payload_dst = nullptr) const {
+        if (!valid_) {
+            return false;
+        }
+        const PayloadSpan body = payload();
+        if (!is_v2()) {
+            if (!verify_v1_checksum()) {
+                return false;
+            }
+        } else if (has_crc() && mode == IntegrityMode::CRC32C) {
+            uint32_t crc = crc32c_extend(CRC32C_INIT, data_, payload_offset_);
+            crc = payload_dst ? crc32c_extend_copy(crc, payload_dst, body.data, body.size)
+                              : crc32c_extend(crc, body.data, body.size);
+            return crc32c_finish(crc) == ntohl(read<uint32_t>(payload_offset_ + body.size));
+        }
+        if (payload_dst) {
+            std::memcpy(payload_dst, body.data, body.size);
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    WireVersion version_;
+    size_t payload_offset_;
+    bool valid_;
+
+    bool is_v2() const { return version_ == WireVersion::V2; }
+    uint16_t timestamp_delta() const {
+        return is_v2() ? ntohs(read<uint16_t>(offsetof(PacketHeaderV2, timestamp_delta))) : 0;
+    }
+
+    template<typename T>
+    T read(size_t offset) const {
+        T value;
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return value;
+    }
+
+    // PacketHeader::calculate_checksum ile aynı: byte toplamı byte sırasından bağımsızdır
+    bool verify_v1_checksum() const {
+        const size_t checksum_offset = offsetof(PacketHeader, checksum);
+        uint32_t sum = 0;
+        for (size_t i = 0; i < PACKET_HEADER_SIZE_V1 - sizeof(uint32_t); ++i) {
+            if (i - checksum_offset < sizeof(uint32_t)) continue;
+            sum += data_[i];
+        }
+        return sum == ntohl(read<uint32_t>(checksum_offset));
+    }
+};
+
+// Göndericiye özgü alım durumu. v2 sıra numaralarını 32 bit'e genişletmek ve frame
+// timestamp'lerini (yalnızca frame'in ilk paketinde gelir) hatırlamak için durum tutar,
+// bu yüzden bir göndericinin paketleri tek bir parser'dan geçmelidir.
+class PacketParser {
+public:
+    PacketParser() : last_sequence_(0), has_sequence_(false), frame_timestamps_(),
+                     integrity_(IntegrityMode::CRC32C), crc_errors_(0) {}
+
+    // UDP_CHECKSUM: gelen CRC'ler doğrulanmaz (payload yine tek memcpy ile kopyalanır)
+    void set_integrity_mode(IntegrityMode mode) { integrity_ = mode; }
+    // CRC uyuşmazlığı nedeniyle reddedilen paket sayısı
+    uint64_t crc_errors() const { return crc_errors_; }
+
+    // Görünümü doğrular ve parser durumunu günceller (bozuk paket duruma dokunmaz).
+    // sequence: 32 bit'e genişletilmiş sıra no; frame_timestamp: 0 = bilinmiyor (v2'de frame'in
+    // ilk paketi kaybolduysa). payload_dst verilirse payload doğrulanırken oraya kopyalanır.
+    bool accept(const PacketView& view, uint32_t& sequence, uint64_t& frame_timestamp,
+                uint8_t* payload_dst = nullptr) {
+        if (!view.verify(integrity_, payload_dst)) {
+            if (view.is_valid() && view.has_crc()) {
+                crc_errors_++;
+            }
+            return false;
+        }
+
+        if (view.version() == WireVersion::V1) {
+            sequence = view.sequence_number();
+            frame_timestamp = view.frame_timestamp();
+            track_sequence(sequence); // v1 -> v2 geçişinde süreklilik için
+            return true;
+        }
+
+        // Yalnızca video paketleri frame'e aittir; heartbeat/kontrol paketleri timestamp'ini
+        // her zaman kendisi taşır ve frame_id'leri video frame'lerinin slotunu ezmemeli
+        if (view.packet_type() != static_cast<uint8_t>(PacketType::VIDEO_DATA)) {
+            frame_timestamp = view.frame_timestamp();
+        } else {
+            const uint32_t frame_id = view.frame_id();
+            FrameTimestamp& slot = frame_timestamps_[frame_id % FRAME_TIMESTAMP_SLOTS];
+            if (view.has_frame_timestamp()) {
+                slot.frame_id = frame_id;
+                slot.timestamp = view.frame_timestamp();
+            }
+            frame_timestamp = slot.frame_id == frame_id ? slot.timestamp : 0;
+        }
+
+        const uint16_t low = static_cast<uint16_t>(view.sequence_number());
+        sequence = has_sequence_ ? extend_sequence_number(low, last_sequence_) : low;
+        track_sequence(sequence);
+        return true;
+    }
+
+    // Datagram'ı Packet'e çözer (payload kopyalanır). Geçersiz, kesik veya bütünlüğü
+    // bozuk datagramlar için false.
+    bool parse(const uint8_t* data, size_t size, Packet& packet) {
+        const PacketView view(data, size);
+        uint32_t sequence;
+        uint64_t frame_timestamp;
+        if (!accept(view, sequence, frame_timestamp, packet.payload.data())) {
+            return false;
+        }
+
+        packet.wire_version = static_cast<uint8_t>(view.version());
+        packet.frame_timestamp = frame_timestamp;
+        if (view.version() == WireVersion::V1) {
+            // Başlık olduğu gibi (checksum ve reserved PacketValidator için korunur)
+            std::memcpy(&packet.header, data, PACKET_HEADER_SIZE_V1);
+            packet.header.to_host_order();
+            return true;
+        }
+
+        packet.header = PacketHeader();
+        packet.header.sequence_number = sequence;
+        packet.header.timestamp = frame_timestamp ? frame_timestamp + view.timestamp_delta_us() : 0;
+        packet.header.packet_type = view.packet_type();
+        packet.header.port_id = view.port_id();
+        packet.header.payload_size = view.payload_size();
+        packet.header.frame_id = view.frame_id();
+        packet.header.nal_unit_id = view.nal_unit_id();
+        return true;
+    }
+
+private:
+    static constexpr size_t FRAME_TIMESTAMP_SLOTS = 16;
+
+    struct FrameTimestamp {
+        uint32_t frame_id = 0;
+        uint64_t timestamp = 0; // 0 = bilinmiyor
+    };
+
+    uint32_t last_sequence_;
+    bool has_sequence_;
+    std::array<FrameTimestamp, FRAME_TIMESTAMP_SLOTS> frame_timestamps_;
+    IntegrityMode integrity_;
+    uint64_t crc_errors_;
+
+    // Genişletme referansı: görülen en yeni sıra numarası
+    void track_sequence(uint32_t sequence) {
+        if (!has_sequence_ || static_cast<int32_t>(sequence - last_sequence_) > 0) {
+            last_sequence_ = sequence;
+            has_sequence_ = true;
+        }
+    }
+};
+
 // Paket oluşturucu yardımcı sınıfı
 class PacketBuilder {
 public:
+    // frame_timestamp: frame'in tüm paketleri için ortak taban ve paketin zamanı (saat
+    // okunmaz); 0 = paket zamanı şimdi alınır
     static Packet create_video_packet(uint32_t sequence_number,
                                     uint32_t frame_id,
                                     uint32_t nal_unit_id,
                                     const uint8_t* data,
                                     size_t data_size,
-                                    uint8_t port_id = 0) {
+                                    uint8_t port_id = 0,
+                                    uint64_t frame_timestamp = 0) {
         Packet packet;
 
-        auto now = std::chrono::high_resolution_clock::now();
-        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
-            now.time_since_epoch()).count();
+        const uint64_t timestamp = frame_timestamp ? frame_timestamp : now_us();
 
         packet.header.sequence_number = sequence_number;
         packet.header.timestamp = timestamp;
+        packet.frame_timestamp = timestamp;
         packet.header.packet_type = static_cast<uint8_t>(PacketType::VIDEO_DATA);
         packet.header.port_id = port_id;
         packet.header.frame_id = frame_id;
         packet.header.nal_unit_id = nal_unit_id;
 
-        // Payload'ı kopyala
-        size_t copy_size = std::min(data_size, PACKET_PAYLOAD_SIZE);
+        // Payload'ı kopyala (sürüme göre sınır serialize sırasında kontrol edilir)
+        size_t copy_size = std::min(data_size, PACKET_MAX_PAYLOAD_SIZE);
         std::memcpy(packet.payload.data(), data, copy_size);
         packet.header.payload_size = static_cast<uint16_t>(copy_size);
 
@@ -177,12 +627,11 @@ public:
     static Packet create_heartbeat_packet(uint32_t sequence_number, uint8_t port_id = 0) {
         Packet packet;
 
-        auto now = std::chrono::high_resolution_clock::now();
-        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
-            now.time_since_epoch()).count();
+        const uint64_t timestamp = now_us();
 
         packet.header.sequence_number = sequence_number;
         packet.header.timestamp = timestamp;
+        packet.frame_timestamp = timestamp;
         packet.header.packet_type = static_cast<uint8_t>(PacketType::HEARTBEAT);
         packet.header.port_id = port_id;
         packet.header.payload_size = 0;
@@ -191,12 +640,40 @@ public:
 
         return packet;
     }
+
+    // Alıcının sürüm teklifi (her zaman v1 ile gönderilir, eski göndericiler yok sayar)
+    static Packet create_capability_packet(uint32_t sequence_number, WireVersion max_version,
+                                           uint8_t port_id = 0) {
+        Packet packet = create_heartbeat_packet(sequence_number, port_id);
+        packet.header.packet_type = static_cast<uint8_t>(PacketType::CONTROL);
+
+        CapabilityPayload capability;
+        capability.control_type = static_cast<uint8_t>(ControlType::CAPABILITY);
+        capability.max_wire_version = static_cast<uint8_t>(max_version);
+        packet.set_payload(capability);
+
+        packet.header.update_checksum();
+        return packet;
+    }
+
+private:
+    // VideoSender::clock_now_us() ile aynı monotonik saat (steady_clock, TscClock ile aynı
+    // epoch); capture PTS'inden türetilen frame timestamp'leriyle karşılaştırılabilir
+    static uint64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 };
 
 // Paket doğrulayıcı
 class PacketValidator {
 public:
     static bool is_valid(const Packet& packet) {
+        // v2: magic/sürüm byte'ı, boyutlar ve (varsa) CRC32C PacketParser'da doğrulandı
+        if (packet.wire_version == static_cast<uint8_t>(WireVersion::V2)) {
+            return packet.header.payload_size <= PACKET_MAX_PAYLOAD_SIZE;
+        }
+
         // Magic number kontrolü
         if (packet.header.magic != 0xDEADBEEF) {
             return false;
@@ -219,9 +696,33 @@ public:
         return packet.header.packet_type == static_cast<uint8_t>(PacketType::VIDEO_DATA);
     }
 
+    static bool is_video_packet(const PacketView& view) {
+        return view.packet_type() == static_cast<uint8_t>(PacketType::VIDEO_DATA);
+    }
+
     static bool is_heartbeat_packet(const Packet& packet) {
         return packet.header.packet_type == static_cast<uint8_t>(PacketType::HEARTBEAT);
     }
+
+    static bool is_heartbeat_packet(const PacketView& view) {
+        return view.packet_type() == static_cast<uint8_t>(PacketType::HEARTBEAT);
+    }
+
+    // CONTROL/CAPABILITY paketiyse karşı tarafın en yüksek sürümünü döndürür
+    static bool get_capability(const Packet& packet, WireVersion& max_version) {
+        if (packet.header.packet_type != static_cast<uint8_t>(PacketType::CONTROL) ||
+            packet.header.payload_size < sizeof(CapabilityPayload)) {
+            return false;
+        }
+        const auto capability = packet.get_payload<CapabilityPayload>();
+        if (capability.control_type != static_cast<uint8_t>(ControlType::CAPABILITY) ||
+            capability.max_wire_version < static_cast<uint8_t>(WireVersion::V1)) {
+            return false;
+        }
+        max_version = static_cast<WireVersion>(
+            std::min(capability.max_wire_version, static_cast<uint8_t>(WIRE_VERSION_MAX)));
+        return true;
+    }
 };
 
 } // namespace udp_streaming
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define UDP_TSC_CLOCK_X86 1
+#endif
+
+namespace udp_streaming {
+
+// Monotonik saat (µs). steady_clock ile aynı epoch'u kullanır (Linux'ta CLOCK_MONOTONIC,
+// GStreamer'ın sistem saatiyle aynı), bu yüzden capture PTS'inden türetilen frame
+// timestamp'leriyle karşılaştırılabilir. x86-64'te invariant TSC varsa başlangıçta
+// steady_clock'un ns okumalarına karşı kalibre edilir; okuma rdtsc + çarpmadır. Kalibrasyon
+// hatası ve NTP'nin CLOCK_MONOTONIC hızına yaptığı düzeltmeler birikmesin diye her thread
+// REANCHOR_PERIOD'da bir steady_clock'a yeniden bağlanır (thread içinde geri gitmez).
+// Invariant TSC yoksa steady_clock'a düşülür. vDSO clock_gettime da ucuz olduğundan kazanç
+// birkaç ns/okuma mertebesindedir; asıl fark, saat kaynağı vDSO'yu desteklemediğinde (bazı
+// sanal makineler) okumanın sistem çağrısına düşmemesidir.
+class TscClock {
+public:
+    // İlk çağrıda kalibre edilir (~100 ms bekler), başlangıçta çağrılmalı
+    static const TscClock& instance() {
+        static const TscClock clock;
+        return clock;
+    }
+
+    bool uses_tsc() const { return uses_tsc_; }
+
+    uint64_t now_us() const {
+#ifdef UDP_TSC_CLOCK_X86
+        if (uses_tsc_) {
+            thread_local Anchor anchor;
+            const uint64_t ticks = __rdtsc();
+            if (ticks - anchor.ticks >= reanchor_ticks_) {
+                anchor.ns = sample(anchor.ticks);
+            }
+            const uint64_t ns = anchor.ns + static_cast<uint64_t>(
+                static_cast<double>(ticks > anchor.ticks ? ticks - anchor.ticks : 0) * ns_per_tick_);
+            if (ns > anchor.last_ns) {
+                anchor.last_ns = ns;
+            }
+            return anchor.last_ns / 1000;
+        }
+#endif
+        return steady_now_ns() / 1000;
+    }
+
+private:
+    static constexpr std::chrono::milliseconds CALIBRATION_PERIOD{100};
+    static constexpr std::chrono::milliseconds REANCHOR_PERIOD{100};
+
+    // Thread başına steady_clock referansı (ticks = 0 ilk okumada bağlanmaya zorlar)
+    struct Anchor {
+        uint64_t ns = 0;
+        uint64_t ticks = 0;
+        uint64_t last_ns = 0;
+    };
+
+    bool uses_tsc_;
+    double ns_per_tick_;
+    uint64_t reanchor_ticks_;
+
+    TscClock() : uses_tsc_(false), ns_per_tick_(0.0), reanchor_ticks_(0) {
+#ifdef UDP_TSC_CLOCK_X86
+        if (!has_invariant_tsc()) {
+            return;
+        }
+        uint64_t start_ticks = 0;
+        const uint64_t start_ns = sample(start_ticks);
+        std::this_thread::sleep_for(CALIBRATION_PERIOD);
+        uint64_t end_ticks = 0;
+        const uint64_t end_ns = sample(end_ticks);
+        if (end_ticks <= start_ticks || end_ns <= start_ns) {
+            return;
+        }
+        ns_per_tick_ = static_cast<double>(end_ns - start_ns) / static_cast<double>(end_ticks - start_ticks);
+        reanchor_ticks_ = static_cast<uint64_t>(
+            std::chrono::duration<double, std::nano>(REANCHOR_PERIOD).count() / ns_per_tick_);
+        uses_tsc_ = true;
+#endif
+    }
+
+    static uint64_t steady_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+#ifdef UDP_TSC_CLOCK_X86
+    // steady_clock okumasını iki rdtsc arasına alır, tick olarak ortalarını verir. Okuma
+    // kesintiye uğradıysa (aralık uzun) en dar aralıklı deneme kullanılır.
+    static uint64_t sample(uint64_t& ticks) {
+        uint64_t best_ns = 0;
+        uint64_t best_width = UINT64_MAX;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            const uint64_t before = __rdtsc();
+            const uint64_t ns = steady_now_ns();
+            const uint64_t after = __rdtsc();
+            if (after - before < best_width) {
+                best_width = after - before;
+                best_ns = ns;
+                ticks = before + best_width / 2;
+            }
+        }
+        return best_ns;
+    }
+
+    // Frekansı güç durumlarından bağımsız ve çekirdekler arası senkron TSC (CPUID 0x80000007 EDX[8])
+    static bool has_invariant_tsc() {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+            return false;
+        }
+        __cpuid(0x80000007, eax, ebx, ecx, edx);
+        return (edx >> 8) & 1;
+    }
+#endif
+};
+
+} // namespace udp_streaming
@@ -1,4 +1,5 @@
 #include "video_receiver.hpp"
+#include "common/logger.hpp"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -8,7 +9,8 @@ namespace udp_streaming {
 
 VideoReceiver::VideoReceiver(const std::vector<uint16_t>& ports)
     : pipeline_(nullptr), appsrc_(nullptr), decoder_(nullptr), appsink_(nullptr)
-    , is_running_(false), expected_sequence_(0) {
+    , is_running_(false), expected_sequence_(0), control_sequence_(0)
+    , first_frame_timestamp_(0) {
     
     config_.ports = ports;
     
@@ -131,16 +133,50 @@ void VideoReceiver::receive_packet() {
     for (size_t i = 0; i < sockets_.size(); ++i) {
         if (!sockets_[i]->is_open()) continue;
         
-        Packet packet;
         asio::ip::udp::endpoint sender_endpoint;
         
         try {
             size_t received = sockets_[i]->receive_from(
-                asio::buffer(&packet, sizeof(packet)), sender_endpoint);
+                asio::buffer(receive_buffer_), sender_endpoint);
             
             if (received > 0) {
-                packet.to_host_order();
-                process_packet(packet, sender_endpoint);
+                // Header alım buffer'ında yerinde okunur; video payload'ı doğrulanırken
+                // tek geçişte nihai GstBuffer'a kopyalanır (ara Packet kopyası yok)
+                const PacketView view(receive_buffer_.data(), received);
+                GstBuffer* payload = nullptr;
+                GstMapInfo map;
+                if (view.is_valid() && PacketValidator::is_video_packet(view)) {
+                    payload = gst_buffer_new_allocate(nullptr, view.payload_size(), nullptr);
+                    if (!gst_buffer_map(payload, &map, GST_MAP_WRITE)) {
+                        gst_buffer_unref(payload);
+                        continue;
+                    }
+                }
+                
+                uint32_t sequence;
+                uint64_t frame_timestamp;
+                const uint64_t crc_errors = parser_.crc_errors();
+                const bool accepted = parser_.accept(view, sequence, frame_timestamp,
+                                                     payload ? map.data : nullptr);
+                if (payload) {
+                    gst_buffer_unmap(payload, &map);
+                }
+                if (!accepted) {
+                    if (payload) {
+                        gst_buffer_unref(payload);
+                    }
+                    if (parser_.crc_errors() != crc_errors) {
+                        stats_.packets_corrupted++;
+                        UDP_LOG_WARN("CRC32C uyuşmazlığı, paket atıldı (%zu byte, port %u)",
+                                     received, config_.ports[i]);
+                    } else {
+                        UDP_LOG_WARN("Çözümlenemeyen paket alındı (%zu byte)", received);
+                    }
+                    continue;
+                }
+                // v2'deki göndericilere de yinelenir (kira); V1'e sabitlenmiş alıcı V1 teklif eder
+                offer_capability(i, sender_endpoint);
+                process_packet(view, sequence, frame_timestamp, payload, sender_endpoint);
             }
         } catch (const std::exception& e) {
             // Socket hatası, devam et
@@ -148,27 +184,51 @@ void VideoReceiver::receive_packet() {
     }
 }
 
-void VideoReceiver::process_packet(const Packet& packet, const asio::ip::udp::endpoint& sender) {
+// İstatistik ortalaması (1/16), ilk örnekle başlar
+static double ewma(double average, double sample) {
+    return average == 0.0 ? sample : average + (sample - average) / 16.0;
+}
+
+void VideoReceiver::process_packet(const PacketView& view, uint32_t sequence, uint64_t frame_timestamp,
+                                   GstBuffer* payload, const asio::ip::udp::endpoint& sender) {
     (void)sender; // Unused parameter
     
-    if (!PacketValidator::is_valid(packet)) {
-        std::cerr << "Geçersiz paket alındı" << std::endl;
-        return;
-    }
-    
     stats_.packets_received++;
     
-    // Jitter buffer'a ekle
+    // Frame timestamp'i göndericinin capture zamanıdır (0 = frame'in ilk paketi kayıp)
+    if (payload && frame_timestamp != 0) {
+        const uint64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (now_us > frame_timestamp) {
+            const double latency_ms = static_cast<double>(now_us - frame_timestamp) / 1000.0;
+            stats_.avg_latency_ms = ewma(stats_.avg_latency_ms, latency_ms);
+        }
+        if (view.timestamp_delta_saturated()) {
+            stats_.timestamp_deltas_saturated++;
+        } else if (view.timestamp_delta_us() > 0) {
+            const double send_delay_ms = static_cast<double>(view.timestamp_delta_us()) / 1000.0;
+            stats_.avg_send_delay_ms = ewma(stats_.avg_send_delay_ms, send_delay_ms);
+        }
+        
+        // PTS ilk frame'e göre (gönderici saatinin epoch'u alıcıda anlamsız)
+        if (first_frame_timestamp_ == 0) {
+            first_frame_timestamp_ = frame_timestamp;
+        }
+        if (frame_timestamp >= first_frame_timestamp_) {
+            GST_BUFFER_PTS(payload) = (frame_timestamp - first_frame_timestamp_) * 1000;
+        }
+    }
+    
+    // Jitter buffer'a ekle (payload'ın sahipliği buffer'a geçer)
     {
         std::lock_guard<std::mutex> lock(buffer_mutex_);
         
-        PacketInfo info;
-        info.packet = packet;
+        PacketInfo& info = jitter_buffer_[sequence];
+        info.payload.reset(payload);
+        info.packet_type = view.packet_type();
         info.arrival_time = std::chrono::steady_clock::now();
         info.is_complete = true;
         
-        jitter_buffer_[packet.header.sequence_number] = info;
-        
         // Buffer boyutunu kontrol et
         if (jitter_buffer_.size() > static_cast<size_t>(config_.jitter_buffer_size)) {
             auto oldest = jitter_buffer_.begin();
@@ -179,6 +239,31 @@ void VideoReceiver::process_packet(const Packet& packet, const asio::ip::udp::en
     buffer_cv_.notify_one();
 }
 
+void VideoReceiver::offer_capability(size_t socket_index, const asio::ip::udp::endpoint& sender) {
+    const auto now = std::chrono::steady_clock::now();
+    auto it = capability_offers_.find(sender);
+    if (it != capability_offers_.end() && now - it->second < CAPABILITY_OFFER_INTERVAL) {
+        return;
+    }
+    capability_offers_[sender] = now;
+    
+    // Teklif v1 ile gider: yeni göndericiler sürüm yükseltir, eskiler portlarını okumaz
+    Packet offer = PacketBuilder::create_capability_packet(
+        control_sequence_++, config_.max_wire_version, static_cast<uint8_t>(socket_index));
+    // Alım buffer'ı çağıranın PacketView'ına ait, teklif ayrı buffer'da serialize edilir
+    std::array<uint8_t, PACKET_HEADER_SIZE_V1 + sizeof(CapabilityPayload)> datagram;
+    const size_t size = PacketSerializer::serialize(offer, WireVersion::V1, datagram.data(), datagram.size());
+    asio::error_code error;
+    sockets_[socket_index]->send_to(asio::buffer(datagram.data(), size), sender, 0, error);
+    if (error) {
+        UDP_LOG_WARN("Sürüm teklifi gönderilemedi: %s", error.message().c_str());
+    } else {
+        UDP_LOG_DEBUG("Sürüm teklifi gönderildi: v%u -> %s:%u",
+                      static_cast<unsigned>(config_.max_wire_version),
+                      sender.address().to_string().c_str(), sender.port());
+    }
+}
+
 void VideoReceiver::jitter_buffer_loop() {
     while (is_running_.load()) {
         std::unique_lock<std::mutex> lock(buffer_mutex_);
@@ -196,21 +281,12 @@ void VideoReceiver::jitter_buffer_loop() {
                 continue;
             }
             
-            const Packet& packet = it->second.packet;
-            
-            // Video paketini GStreamer'a gönder
-            if (PacketValidator::is_video_packet(packet)) {
-                GstBuffer* buffer = gst_buffer_new_allocate(nullptr, packet.header.payload_size, nullptr);
-                GstMapInfo map;
-                
-                if (gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
-                    std::memcpy(map.data, packet.get_payload_data(), packet.header.payload_size);
-                    gst_buffer_unmap(buffer, &map);
-                    
-                    GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(appsrc_), buffer);
-                    if (ret != GST_FLOW_OK) {
-                        std::cerr << "GStreamer buffer push hatası" << std::endl;
-                    }
+            // Video paketini GStreamer'a gönder (buffer alımda dolduruldu, kopya yok)
+            PacketInfo& info = it->second;
+            if (info.packet_type == static_cast<uint8_t>(PacketType::VIDEO_DATA) && info.payload) {
+                GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(appsrc_), info.payload.release());
+                if (ret != GST_FLOW_OK) {
+                    UDP_LOG_WARN("GStreamer buffer push hatası");
                 }
             }
             
@@ -325,6 +401,14 @@ void VideoReceiver::set_max_latency(int ms) {
     config_.max_latency_ms = ms;
 }
 
+void VideoReceiver::set_max_wire_version(WireVersion version) {
+    config_.max_wire_version = version;
+}
+
+void VideoReceiver::set_integrity_mode(IntegrityMode mode) {
+    parser_.set_integrity_mode(mode);
+}
+
 VideoReceiver::Stats VideoReceiver::get_stats() const {
     return stats_;
 }
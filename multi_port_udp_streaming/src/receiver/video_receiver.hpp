@@ -34,8 +34,14 @@ private:
     std::atomic<bool> is_running_;
     
     // Jitter buffer
+    struct GstBufferUnref {
+        void operator()(GstBuffer* buffer) const { gst_buffer_unref(buffer); }
+    };
+    
+    // Video payload'ı alımda doğrudan pipeline'a gidecek GstBuffer'a kopyalanır
     struct PacketInfo {
-        Packet packet;
+        std::unique_ptr<GstBuffer, GstBufferUnref> payload;
+        uint8_t packet_type = 0;
         std::chrono::steady_clock::time_point arrival_time;
         bool is_complete = false;
     };
@@ -45,6 +51,14 @@ private:
     std::condition_variable buffer_cv_;
     uint32_t expected_sequence_;
     
+    // Kablo formatı (yalnızca IO thread'i): sürüm paket başına algılanır, her göndericiye
+    // CAPABILITY_OFFER_INTERVAL'da bir en yüksek sürüm teklif edilir (göndericinin kirası)
+    PacketParser parser_;
+    std::array<uint8_t, PACKET_MAX_DATAGRAM_SIZE> receive_buffer_;
+    std::map<asio::ip::udp::endpoint, std::chrono::steady_clock::time_point> capability_offers_;
+    uint32_t control_sequence_;
+    uint64_t first_frame_timestamp_; // Buffer PTS'lerinin sıfır noktası (capture zamanı, µs)
+    
     // Configuration
     struct Config {
         int width = 1280;
@@ -54,6 +68,7 @@ private:
         std::vector<uint16_t> ports = {5000, 5001, 5002, 5003};
         int jitter_buffer_size = 100;
         int max_latency_ms = 150;
+        WireVersion max_wire_version = WIRE_VERSION_MAX;
     } config_;
     
     // Methods
@@ -61,7 +76,9 @@ private:
     void setup_gstreamer();
     void gstreamer_loop();
     void receive_packet();
-    void process_packet(const Packet& packet, const asio::ip::udp::endpoint& sender);
+    void process_packet(const PacketView& view, uint32_t sequence, uint64_t frame_timestamp,
+                        GstBuffer* payload, const asio::ip::udp::endpoint& sender);
+    void offer_capability(size_t socket_index, const asio::ip::udp::endpoint& sender);
     void jitter_buffer_loop();
     void reassemble_frame(uint32_t frame_id);
     static void on_new_sample(GstElement* sink, VideoReceiver* receiver);
@@ -82,13 +99,24 @@ public:
     void set_decoder(const std::string& decoder);
     void set_jitter_buffer_size(int size);
     void set_max_latency(int ms);
+    // Göndericilere teklif edilen en yüksek kablo sürümü (V1 = göndericiler v1'e döndürülür)
+    void set_max_wire_version(WireVersion version);
+    // UDP_CHECKSUM: v2 paketlerindeki CRC32C doğrulanmaz
+    void set_integrity_mode(IntegrityMode mode);
     
     // Statistics
     struct Stats {
         uint32_t packets_received = 0;
         uint32_t packets_lost = 0;
+        uint32_t packets_corrupted = 0; // CRC32C uyuşmazlığı ile atılan
         uint32_t frames_decoded = 0;
+        // Capture -> alım (EWMA). Gönderici ile aynı CLOCK_MONOTONIC'i gerektirir (aynı host);
+        // farklı hostlarda saatler arası ofseti de içerir. v1'de TSC modunda paketler capture
+        // yerine gönderim zamanını taşır.
         double avg_latency_ms = 0.0;
+        // Capture -> gönderim (EWMA, yalnızca gönderici TSC paket saatiyle çalışıyorsa)
+        double avg_send_delay_ms = 0.0;
+        uint32_t timestamp_deltas_saturated = 0; // Aralığı aşan capture -> gönderim farkı
         double packet_loss_rate = 0.0;
     } stats_;
     
@@ -1,4 +1,5 @@
 #include "video_sender.hpp"
+#include "common/logger.hpp"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -7,7 +8,8 @@ namespace udp_streaming {
 
 VideoSender::VideoSender(const std::string& remote_ip, const std::vector<uint16_t>& ports)
     : pipeline_(nullptr), appsrc_(nullptr), encoder_(nullptr), appsink_(nullptr)
-    , is_running_(false), sequence_number_(0) {
+    , is_running_(false), sequence_number_(0)
+    , wire_version_(static_cast<uint8_t>(WireVersion::V1)), wire_version_offer_us_(0) {
     
     config_.remote_ip = remote_ip;
     config_.ports = ports;
@@ -30,6 +32,11 @@ bool VideoSender::initialize() {
     try {
         setup_sockets();
         setup_gstreamer();
+        if (config_.tsc_clock) {
+            // Kalibrasyon paket yolunda değil, başlangıçta yapılır
+            const bool uses_tsc = TscClock::instance().uses_tsc();
+            std::cout << "Paket saati: " << (uses_tsc ? "TSC" : "steady_clock (invariant TSC yok)") << std::endl;
+        }
         return true;
     } catch (const std::exception& e) {
         std::cerr << "VideoSender initialize hatası: " << e.what() << std::endl;
@@ -41,6 +48,8 @@ void VideoSender::setup_sockets() {
     for (uint16_t port : config_.ports) {
         auto socket = std::make_unique<asio::ip::udp::socket>(io_context_);
         socket->open(asio::ip::udp::v4());
+        // Alıcının sürüm teklifi bu porta döner (ilk gönderimden önce de dinlenebilsin)
+        socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), 0));
         
         asio::ip::udp::endpoint endpoint(
             asio::ip::make_address(config_.remote_ip), port);
@@ -50,6 +59,39 @@ void VideoSender::setup_sockets() {
         
         std::cout << "Socket oluşturuldu: " << config_.remote_ip << ":" << port << std::endl;
     }
+    
+    feedback_buffers_.resize(sockets_.size());
+    feedback_sources_.resize(sockets_.size());
+}
+
+void VideoSender::start_feedback_receive(size_t socket_index) {
+    sockets_[socket_index]->async_receive_from(
+        asio::buffer(feedback_buffers_[socket_index]), feedback_sources_[socket_index],
+        [this, socket_index](const asio::error_code& error, size_t received) {
+            if (error == asio::error::operation_aborted || !sockets_[socket_index]->is_open()) {
+                return;
+            }
+            if (!error) {
+                handle_feedback(feedback_buffers_[socket_index].data(), received);
+            }
+            start_feedback_receive(socket_index);
+        });
+}
+
+void VideoSender::handle_feedback(const uint8_t* data, size_t size) {
+    Packet packet;
+    WireVersion remote_version;
+    if (!feedback_parser_.parse(data, size, packet) || !PacketValidator::is_valid(packet) ||
+        !PacketValidator::get_capability(packet, remote_version)) {
+        return;
+    }
+    
+    const uint8_t version = std::min(static_cast<uint8_t>(remote_version),
+                                     static_cast<uint8_t>(config_.max_wire_version));
+    wire_version_offer_us_ = clock_now_us();
+    if (wire_version_.exchange(version) != version) {
+        UDP_LOG_INFO("Kablo sürümü alıcıyla anlaşıldı: v%u", static_cast<unsigned>(version));
+    }
 }
 
 void VideoSender::setup_gstreamer() {
@@ -130,51 +172,91 @@ void VideoSender::gstreamer_loop() {
     gst_object_unref(bus);
 }
 
-void VideoSender::send_packet(const Packet& packet) {
+void VideoSender::send_datagram(const PacketHeader& header, uint64_t frame_timestamp, WireVersion version,
+                                const uint8_t* payload) {
     // Round-robin ile paketleri farklı portlara dağıt
     static size_t current_port = 0;
     size_t port_index = current_port % sockets_.size();
     current_port++;
     
     try {
-        Packet network_packet = packet;
-        network_packet.to_network_order();
+        const size_t header_size = PacketSerializer::serialize_header(
+            header, frame_timestamp, version, header_buffer_.data(), header_buffer_.size(), config_.integrity);
+        if (header_size == 0) {
+            UDP_LOG_WARN("Paket serialize edilemedi (payload %u byte)", header.payload_size);
+            return;
+        }
+        
+        // Payload kopyalanmaz: header, payload ve trailer tek datagram olarak gider
+        uint32_t crc_trailer = 0;
+        size_t trailer_size = 0;
+        if (version == WireVersion::V2 && config_.integrity == IntegrityMode::CRC32C) {
+            crc_trailer = PacketSerializer::crc_trailer(header_buffer_.data(), header_size,
+                                                        payload, header.payload_size);
+            trailer_size = sizeof(crc_trailer);
+        }
+        const std::array<asio::const_buffer, 3> buffers = {
+            asio::buffer(header_buffer_.data(), header_size),
+            asio::buffer(payload, header.payload_size),
+            asio::buffer(&crc_trailer, trailer_size)
+        };
+        const size_t size = header_size + header.payload_size + trailer_size;
         
-        size_t sent = sockets_[port_index]->send_to(
-            asio::buffer(&network_packet, network_packet.get_total_size()),
-            endpoints_[port_index]);
+        size_t sent = sockets_[port_index]->send_to(buffers, endpoints_[port_index]);
         
-        if (sent != network_packet.get_total_size()) {
-            std::cerr << "Paket tam gönderilemedi: " << sent << "/" 
-                     << network_packet.get_total_size() << " byte" << std::endl;
+        if (sent != size) {
+            UDP_LOG_WARN("Paket tam gönderilemedi: %zu/%zu byte", sent, size);
         }
     } catch (const std::exception& e) {
-        std::cerr << "Paket gönderme hatası: " << e.what() << std::endl;
+        UDP_LOG_WARN("Paket gönderme hatası: %s", e.what());
     }
 }
 
-void VideoSender::packetize_video_data(const uint8_t* data, size_t size, uint32_t frame_id) {
-    const size_t max_payload_size = PACKET_PAYLOAD_SIZE;
+uint64_t VideoSender::clock_now_us() const {
+    if (config_.tsc_clock) {
+        return TscClock::instance().now_us();
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void VideoSender::packetize_video_data(const uint8_t* data, size_t size, uint32_t frame_id,
+                                       uint64_t capture_time_us) {
+    // Sürüm frame ortasında değişmez; v2'de küçülen header payload'a kalır. Alıcı teklifini
+    // yinelemeyi bıraktıysa (eski sürümle yeniden başladı) v2 paketlerini okuyamaz, v1'e dönülür
+    // (teklif zamanı IO thread'inde yazılır, şimdiki zamandan biraz ileride olabilir)
+    const uint64_t lease_end_us = wire_version_offer_us_.load() +
+        static_cast<uint64_t>(std::chrono::microseconds(WIRE_VERSION_LEASE).count());
+    if (wire_version() != WireVersion::V1 && clock_now_us() > lease_end_us) {
+        wire_version_ = static_cast<uint8_t>(WireVersion::V1);
+        UDP_LOG_WARN("Alıcıdan %lld sn'dir sürüm teklifi gelmedi, v1'e dönüldü",
+                     static_cast<long long>(WIRE_VERSION_LEASE.count()));
+    }
+    const WireVersion version = wire_version();
+    const size_t chunk_limit = max_payload_size(version);
+    // Frame timestamp'i = capture zamanı; paketler yalnızca ondan farkını taşır
+    const uint64_t frame_timestamp = capture_time_us;
     size_t offset = 0;
-    uint32_t nal_unit_id = 0;
+    
+    // Payload'lar data'dan (eşlenmiş GstBuffer) doğrudan gönderilir; Packet oluşturulmaz
+    PacketHeader header;
+    header.packet_type = static_cast<uint8_t>(PacketType::VIDEO_DATA);
+    header.frame_id = frame_id;
+    header.nal_unit_id = 0;
     
     while (offset < size) {
-        size_t chunk_size = std::min(max_payload_size, size - offset);
+        size_t chunk_size = std::min(chunk_limit, size - offset);
         
-        auto packet = PacketBuilder::create_video_packet(
-            sequence_number_,
-            frame_id,
-            nal_unit_id,
-            data + offset,
-            chunk_size,
-            static_cast<uint8_t>(sequence_number_ % config_.ports.size())
-        );
+        header.sequence_number = sequence_number_;
+        header.timestamp = config_.tsc_clock ? TscClock::instance().now_us() : frame_timestamp;
+        header.port_id = static_cast<uint8_t>(sequence_number_ % config_.ports.size());
+        header.payload_size = static_cast<uint16_t>(chunk_size);
         
-        send_packet(packet);
+        send_datagram(header, frame_timestamp, version, data + offset);
         
         offset += chunk_size;
         sequence_number_++;
-        nal_unit_id++;
+        header.nal_unit_id++;
     }
 }
 
@@ -185,9 +267,15 @@ void VideoSender::on_new_sample(GstElement* sink, VideoSender* sender) {
     GstBuffer* buffer = gst_sample_get_buffer(sample);
     GstMapInfo map;
     
+    // Eşleme (ve sample referansı) frame'in tüm paketleri gönderilene kadar tutulur
     if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
         static uint32_t frame_id = 0;
-        sender->packetize_video_data(map.data, map.size, frame_id++);
+        // Capture zamanı: PTS + pipeline base time = GStreamer saat zamanı (sistem saati,
+        // monotonik; steady_clock ile aynı epoch). PTS yoksa çıkış zamanı kullanılır.
+        const uint64_t capture_time_us = GST_BUFFER_PTS_IS_VALID(buffer)
+            ? (gst_element_get_base_time(sender->pipeline_) + GST_BUFFER_PTS(buffer)) / 1000
+            : sender->clock_now_us();
+        sender->packetize_video_data(map.data, map.size, frame_id++, capture_time_us);
         gst_buffer_unmap(buffer, &map);
     }
     
@@ -209,7 +297,12 @@ bool VideoSender::start() {
     
     std::cout << "VideoSender başlatılıyor..." << std::endl;
     
-    // IO thread'i başlat
+    // IO thread'i başlat (alıcıdan gelen sürüm tekliflerini dinler)
+    if (config_.max_wire_version != WireVersion::V1) {
+        for (size_t i = 0; i < sockets_.size(); ++i) {
+            start_feedback_receive(i);
+        }
+    }
     io_thread_ = std::thread([this]() {
         io_context_.run();
     });
@@ -276,4 +369,19 @@ void VideoSender::set_encoder(const std::string& encoder) {
     config_.encoder = encoder;
 }
 
+void VideoSender::set_integrity_mode(IntegrityMode mode) {
+    config_.integrity = mode;
+}
+
+void VideoSender::set_tsc_clock(bool enabled) {
+    config_.tsc_clock = enabled;
+}
+
+void VideoSender::set_max_wire_version(WireVersion version) {
+    config_.max_wire_version = version;
+    if (static_cast<uint8_t>(version) < wire_version_.load()) {
+        wire_version_ = static_cast<uint8_t>(version);
+    }
+}
+
 } // namespace udp_streaming
@@ -11,6 +11,7 @@
 #include <gst/app/gstappsrc.h>
 #include <gst/app/gstappsink.h>
 #include "common/packet.hpp"
+#include "common/tsc_clock.hpp"
 
 namespace udp_streaming {
 
@@ -37,6 +38,17 @@ private:
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
     uint32_t sequence_number_;
+    // Yalnızca GStreamer thread'i: datagram = header_buffer_ + (eşlenmiş GstBuffer'daki)
+    // payload + CRC trailer'ı, tek sendmsg ile
+    std::array<uint8_t, PacketSerializer::MAX_HEADER_SIZE> header_buffer_;
+    
+    // Kablo sürümü: v1 ile başlanır, alıcının CAPABILITY teklifiyle yükseltilir; son teklif
+    // (clock_now_us) WIRE_VERSION_LEASE'ten eskiyse frame başında v1'e dönülür
+    std::atomic<uint8_t> wire_version_;
+    std::atomic<uint64_t> wire_version_offer_us_;
+    PacketParser feedback_parser_; // Yalnızca IO thread'i
+    std::vector<std::array<uint8_t, PACKET_MAX_DATAGRAM_SIZE>> feedback_buffers_;
+    std::vector<asio::ip::udp::endpoint> feedback_sources_;
     
     // Configuration
     struct Config {
@@ -47,14 +59,21 @@ private:
         std::string encoder = "x264enc";
         std::vector<uint16_t> ports = {5000, 5001, 5002, 5003};
         std::string remote_ip = "127.0.0.1";
+        WireVersion max_wire_version = WIRE_VERSION_MAX;
+        IntegrityMode integrity = IntegrityMode::CRC32C;
+        bool tsc_clock = false; // Paket gönderim zamanı TSC'den (kapalıyken frame zamanı)
     } config_;
     
     // Methods
     void setup_sockets();
     void setup_gstreamer();
     void gstreamer_loop();
-    void send_packet(const Packet& packet);
-    void packetize_video_data(const uint8_t* data, size_t size, uint32_t frame_id);
+    void send_datagram(const PacketHeader& header, uint64_t frame_timestamp, WireVersion version,
+                       const uint8_t* payload);
+    void start_feedback_receive(size_t socket_index);
+    void handle_feedback(const uint8_t* data, size_t size);
+    void packetize_video_data(const uint8_t* data, size_t size, uint32_t frame_id, uint64_t capture_time_us);
+    uint64_t clock_now_us() const;
     static void on_new_sample(GstElement* sink, VideoSender* sender);
     static void on_need_data(GstElement* src, guint size, VideoSender* sender);
     
@@ -72,6 +91,14 @@ public:
     void set_framerate(int fps);
     void set_bitrate(int bitrate);
     void set_encoder(const std::string& encoder);
+    // Kullanılacak en yüksek kablo sürümü (V1 = eski alıcılarla sabit v1)
+    void set_max_wire_version(WireVersion version);
+    WireVersion wire_version() const { return static_cast<WireVersion>(wire_version_.load()); }
+    // v2 paketlerine CRC32C eklensin mi (UDP_CHECKSUM = yalnızca UDP checksum'ına güven)
+    void set_integrity_mode(IntegrityMode mode);
+    // Paketlere gönderim anını TSC saatiyle ekle (initialize()'da kalibre edilir). Kapalıyken
+    // paketler yalnızca frame'in capture zamanını taşır, paket başına saat okunmaz.
+    void set_tsc_clock(bool enabled);
 };
 
 } // namespace udp_streaming
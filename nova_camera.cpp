@@ -5,7 +5,7 @@
 #include <algorithm> // for std::max
 
 NovaCamera::NovaCamera(const std::string& local_ip, int local_port,
-                       const std::string& remote_ip, int remote_port)
+                       const std::string& remote_ip, int remote_port, int multipath_tunnels)
     : local_ip(local_ip), remote_ip(remote_ip), local_port(local_port), remote_port(remote_port) {
 
     // Otomatik donanım tespiti ve en iyi ayarları al
@@ -23,10 +23,12 @@ NovaCamera::NovaCamera(const std::string& local_ip, int local_port,
 
     config.enable_gpu = optimal_settings.hardware_acceleration;
     config.enable_mirror = true; // Ayna efekti açık kalsın
+    config.multipath_tunnels = multipath_tunnels;
 
-    // VideoManager ve HeartbeatManager'ı oluştur
+    // VideoManager ve HeartbeatManager'ı oluştur. Çok yollu modda heartbeat tünel
+    // portlarının dışına gider (engine'in tünel soketlerini kirletmesin).
     video_manager = std::make_unique<VideoManager>(config);
-    heartbeat_manager = std::make_unique<HeartbeatManager>(remote_ip, remote_port);
+    heartbeat_manager = std::make_unique<HeartbeatManager>(remote_ip, remote_port + std::max(0, multipath_tunnels));
 }
 
 bool NovaCamera::initialize() {
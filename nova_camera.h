@@ -17,8 +17,9 @@ private:
     int remote_port;
     
 public:
+    // multipath_tunnels > 0: görüntü NovaEngine ile bu kadar ardışık port üzerinden taşınır
     NovaCamera(const std::string& local_ip, int local_port,
-               const std::string& remote_ip, int remote_port);
+               const std::string& remote_ip, int remote_port, int multipath_tunnels = 0);
 
     bool initialize();
     bool start();
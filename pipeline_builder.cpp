@@ -40,7 +40,8 @@ PipelineBuilder::PipelineBuilder(const VideoConfig& cfg) : config(cfg) {
     init_gst();
 }
 
-std::string PipelineBuilder::buildSenderPipeline(const std::string& remote_ip, int remote_port) {
+// Kamera -> (önizleme) -> encoder zinciri; çıkışı H.264 caps'ine bağlanmaya hazır
+std::string PipelineBuilder::buildCaptureEncoderChain() {
     std::string pipeline;
     
     // GPU tipini tespit et
@@ -106,8 +107,14 @@ std::string PipelineBuilder::buildSenderPipeline(const std::string& remote_ip, i
                    " bframes=0 ref=1 crf=18 ! ";
     }
 
-    // 8. RTP Paketleme ve Ağ Gönderimi
     pipeline += "video/x-h264,profile=high ! ";
+    return pipeline;
+}
+
+std::string PipelineBuilder::buildSenderPipeline(const std::string& remote_ip, int remote_port) {
+    std::string pipeline = buildCaptureEncoderChain();
+
+    // 8. RTP Paketleme ve Ağ Gönderimi
     pipeline += "rtph264pay config-interval=-1 pt=96 mtu=1300 ! ";
     
     // 9. Optimize edilmiş UDP buffer (GPU'dan gelen veriyi hızlıca gönder)
@@ -121,6 +128,29 @@ std::string PipelineBuilder::buildSenderPipeline(const std::string& remote_ip, i
 std::string PipelineBuilder::buildReceiverPipeline(int local_port) {
     std::string pipeline;
     
+    // 1. UDP Kaynağı ve Yüksek Performanslı Buffer
+    pipeline = "udpsrc port=" + std::to_string(local_port) +
+               " buffer-size=1048576 " + // 1MB buffer (ani hareketler için artırıldı)
+               "caps=\"application/x-rtp,media=video,clock-rate=90000,encoding-name=H264,payload=96\" ! ";
+
+    // 2. Optimize edilmiş Jitter Buffer (GPU'ya uygun)
+    pipeline += "queue max-size-buffers=2000 max-size-bytes=0 max-size-time=0 leaky=2 ! ";
+    pipeline += "rtpjitterbuffer mode=1 latency=150 ! ";
+
+    // 3. RTP Depayload
+    pipeline += "rtph264depay ! ";
+
+    // 4-6. Parse, decode ve görüntüleme
+    pipeline += buildDecoderSinkChain();
+
+    std::cout << "RECV PIPELINE: " << pipeline << std::endl;
+    return pipeline;
+}
+
+// h264parse -> decoder -> görüntüleme zinciri
+std::string PipelineBuilder::buildDecoderSinkChain() {
+    std::string pipeline;
+
     // GPU tipini tespit et
     std::string gpu_type = GpuDetector::detectGpuType();
     std::string decoder = GpuDetector::getOptimalGstDecoder();
@@ -134,20 +164,8 @@ std::string PipelineBuilder::buildReceiverPipeline(int local_port) {
     std::cout << "Video Sink: " << videosink << std::endl;
     std::cout << "=================================" << std::endl;
 
-    // 1. UDP Kaynağı ve Yüksek Performanslı Buffer
-    pipeline = "udpsrc port=" + std::to_string(local_port) +
-               " buffer-size=1048576 " + // 1MB buffer (ani hareketler için artırıldı)
-               "caps=\"application/x-rtp,media=video,clock-rate=90000,encoding-name=H264,payload=96\" ! ";
-
-    // 2. Optimize edilmiş Jitter Buffer (GPU'ya uygun)
-    pipeline += "queue max-size-buffers=2000 max-size-bytes=0 max-size-time=0 leaky=2 ! ";
-    pipeline += "rtpjitterbuffer mode=1 latency=150 ! ";
-
-    // 3. RTP Depayload ve Parse
-    pipeline += "rtph264depay ! h264parse ! ";
-
     // 4. GPU Decoder (Tüm kod çözme GPU'da)
-    pipeline += decoder + " ! ";
+    pipeline += "h264parse ! " + decoder + " ! ";
 
     // 5. GPU Video Dönüştürme (CPU kullanımını minimize et)
     pipeline += videoconvert + " ! ";
@@ -155,7 +173,36 @@ std::string PipelineBuilder::buildReceiverPipeline(int local_port) {
     // 6. GPU Video Sink (Görüntüleme GPU'da)
     pipeline += "queue max-size-buffers=20 leaky=2 ! "; // Küçük buffer
     pipeline += videosink + " sync=false";
+    return pipeline;
+}
 
-    std::cout << "RECV PIPELINE: " << pipeline << std::endl;
+std::string PipelineBuilder::buildMultipathSenderPipeline() {
+    std::string pipeline = buildCaptureEncoderChain();
+
+    // 8. Access unit hizalı byte-stream: her buffer bir frame, SPS/PPS her keyframe'de tekrarlanır
+    // (alıcı kayıptan sonra bir sonraki keyframe'den toparlanabilsin)
+    pipeline += "h264parse config-interval=-1 ! ";
+    pipeline += "video/x-h264,stream-format=byte-stream,alignment=au ! ";
+
+    // 9. Slice'lama ve tünellere dağıtım VideoManager'da (TunnelSender)
+    pipeline += "appsink name=multipath_sink sync=false max-buffers=8 drop=false emit-signals=false";
+
+    std::cout << "MULTIPATH SEND PIPELINE: " << pipeline << std::endl;
+    return pipeline;
+}
+
+std::string PipelineBuilder::buildMultipathReceiverPipeline() {
+    std::string pipeline;
+
+    // 1. ReassemblyEngine'in birleştirdiği access unit'ler (PTS'leri göndericiden gelir).
+    // Jitter buffer yok: sıralama, kayıp telafisi ve playout gecikmesi engine'de.
+    pipeline = "appsrc name=multipath_src is-live=true format=time do-timestamp=false "
+               "max-bytes=0 block=false "
+               "caps=\"video/x-h264,stream-format=byte-stream,alignment=au\" ! ";
+
+    // 2-6. Parse, decode ve görüntüleme
+    pipeline += buildDecoderSinkChain();
+
+    std::cout << "MULTIPATH RECV PIPELINE: " << pipeline << std::endl;
     return pipeline;
 }
\ No newline at end of file
@@ -7,8 +7,16 @@ class PipelineBuilder {
 private:
     const VideoConfig& config;
 
+    std::string buildCaptureEncoderChain();
+    std::string buildDecoderSinkChain();
+
 public:
     PipelineBuilder(const VideoConfig& cfg);
     std::string buildSenderPipeline(const std::string& remote_ip, int remote_port);
     std::string buildReceiverPipeline(int local_port);
+
+    // Çok yollu mod: encoder çıktısı appsink'e (multipath_sink), ReassemblyEngine'den gelen
+    // access unit'ler appsrc'ye (multipath_src) bağlanır
+    std::string buildMultipathSenderPipeline();
+    std::string buildMultipathReceiverPipeline();
 };
\ No newline at end of file
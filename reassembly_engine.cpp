@@ -1,6 +1,6 @@
 // reassembly_engine.cpp - NovaEngine Multi-Path UDP Slice Reassembly Implementation
 #include "reassembly_engine.h"
-#include <iostream>
+#include "async_logger.h"
 #include <thread>
 #include <cstring>
 #include <unistd.h>
@@ -9,38 +9,227 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
 
-// Slice header formatı (8 byte)
-struct SliceHeader {
-    uint32_t frame_id;      // 4 byte
-    uint16_t slice_id;      // 2 byte
-    uint16_t total_slices;  // 2 byte
-    uint8_t tunnel_id;      // 1 byte
-    uint8_t reserved;       // 1 byte (gelecek kullanım için)
-} __attribute__((packed));
+// Sarmalanan frame_id'ler için karşılaştırma (a, b'den yeni mi?)
+static inline bool frame_id_newer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
 
 ReassemblyEngine::ReassemblyEngine() 
-    : epoll_fd_(-1), running_(false) {
+    : epoll_fd_(-1), timer_fd_(-1), frames_(FRAME_WINDOW_SIZE), frame_pool_(std::make_shared<FrameBufferPool>()),
+      lost_frame_table_(std::make_unique<LostFrameTable>()), lost_frames_(lost_frame_table_.get()),
+      running_(false), cpu_affinity_(-1), worker_count_(1), pin_to_cores_(false), prober_(nullptr), probing_(false), probe_timer_fd_(-1),
+      reuse_port_(false), shard_index_(0), delivery_(nullptr) {
+    // Deadline heap'i için yer ayır (çalışma sırasında allocation olmasın)
+    std::vector<FrameDeadline> deadline_storage;
+    deadline_storage.reserve(FRAME_WINDOW_SIZE * 2);
+    deadlines_ = decltype(deadlines_)(std::greater<FrameDeadline>(), std::move(deadline_storage));
+    std::vector<FrameDeadline> expiry_storage;
+    expiry_storage.reserve(FRAME_WINDOW_SIZE * 2);
+    expiries_ = decltype(expiries_)(std::greater<FrameDeadline>(), std::move(expiry_storage));
 }
 
 ReassemblyEngine::~ReassemblyEngine() {
     stop();
+    if (timer_fd_ >= 0) {
+        close(timer_fd_);
+    }
+    if (probe_timer_fd_ >= 0) {
+        close(probe_timer_fd_);
+    }
     if (epoll_fd_ >= 0) {
         close(epoll_fd_);
     }
 }
 
+// Reuseport grubuna frame_id % shard_count seçen cBPF programı bağla.
+// UDP için program payload başından çalışır; ilk 4 byte SliceHeader::frame_id'dir.
+static bool attach_shard_steering(int sock_fd, size_t shard_count) {
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, 0 },                                   // A = frame_id
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(shard_count) }, // A %= shard sayısı
+        { BPF_RET | BPF_A, 0, 0, 0 },                                            // soket indeksi
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    return setsockopt(sock_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0;
+}
+
+void ReassemblyEngine::set_worker_count(size_t count, bool pin_to_cores) {
+    worker_count_ = count == 0 ? 1 : count;
+    pin_to_cores_ = pin_to_cores;
+}
+
+void ReassemblyEngine::set_cpu_affinity(int cpu) {
+    cpu_affinity_ = cpu;
+}
+
+void ReassemblyEngine::set_playout_delay(std::chrono::milliseconds delay) {
+    playout_delay_ = delay;
+}
+
+void ReassemblyEngine::set_wait_time_limits(std::chrono::milliseconds min_wait, std::chrono::milliseconds max_wait) {
+    min_wait_time_ = min_wait;
+    max_wait_time_ = std::max(min_wait, max_wait);
+}
+
+void ReassemblyEngine::set_probe_interval(std::chrono::milliseconds interval, double skew_percentile) {
+    probe_interval_ = interval;
+    skew_percentile_ = skew_percentile;
+}
+
+void ReassemblyEngine::set_retransmission(bool enabled, uint8_t max_rounds) {
+    retransmission_enabled_ = enabled;
+    max_nack_rounds_ = max_rounds;
+}
+
+void ReassemblyEngine::set_max_frame_age(std::chrono::milliseconds age) {
+    max_frame_age_ = age;
+}
+
+void ReassemblyEngine::set_memory_budget(size_t bytes) {
+    memory_budget_ = bytes;
+}
+
+void ReassemblyEngine::set_receive_backend(ReceiveBackendType type) {
+    receive_backend_type_ = type;
+}
+
+void ReassemblyEngine::set_udp_gro(bool enabled) {
+    udp_gro_ = enabled;
+}
+
+void ReassemblyEngine::set_busy_poll(std::chrono::microseconds spin_budget,
+                                     std::chrono::microseconds socket_busy_poll) {
+    busy_poll_budget_ = spin_budget;
+    socket_busy_poll_ = socket_busy_poll;
+}
+
+std::chrono::milliseconds ReassemblyEngine::frame_expiry_age() const {
+    if (max_frame_age_.count() > 0) {
+        return std::max(max_frame_age_, max_wait_time_);
+    }
+    return playout_delay_.count() > 0 ? std::max(playout_delay_, max_wait_time_) : max_wait_time_ * 2;
+}
+
+void ReassemblyEngine::create_delivery_stage(size_t producer_count, std::chrono::milliseconds playout_delay) {
+    // Teslim aşaması sonuçları sıraya koyup bu nesnenin callback'lerini çağırır
+    delivery_stage_ = std::make_unique<FrameDeliveryStage>(
+        producer_count, FRAME_WINDOW_SIZE, playout_delay,
+        [this](CompletedFrame& frame, const FrameTiming& timing) {
+            metrics_.on_frame_delivered(timing.delivered_time - timing.first_slice_time);
+            if (frame_timing_callback_) frame_timing_callback_(frame.frame_id, timing);
+            if (frame_handle_callback_) {
+                frame_handle_callback_(FrameHandle(frame.frame_id, std::move(frame.data), frame.pool));
+            } else if (frame_complete_callback_) {
+                frame_complete_callback_(frame.frame_id, frame.data);
+            }
+        },
+        [this](uint32_t frame_id) {
+            if (frame_discard_callback_) frame_discard_callback_(frame_id);
+        });
+}
+
+bool ReassemblyEngine::initialize_shards(const std::vector<std::string>& tunnel_ips,
+                                         const std::vector<int>& tunnel_ports) {
+    create_delivery_stage(worker_count_, playout_delay_.count() > 0 ? playout_delay_ : max_wait_time_ * 2);
+    if (probe_interval_.count() > 0) {
+        tunnel_prober_ = std::make_unique<TunnelProber>(skew_percentile_);
+        prober_ = tunnel_prober_.get();
+    }
+    
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < worker_count_; ++i) {
+        auto shard = std::make_unique<ReassemblyEngine>();
+        shard->reuse_port_ = true;
+        shard->shard_index_ = i;
+        shard->delivery_ = delivery_stage_.get();
+        shard->max_wait_time_ = max_wait_time_;
+        shard->min_wait_time_ = min_wait_time_;
+        shard->max_frame_age_ = frame_expiry_age(); // Shard'ın playout_delay_'i yok
+        shard->probe_interval_ = probe_interval_;
+        shard->prober_ = prober_;
+        shard->retransmission_enabled_ = retransmission_enabled_;
+        shard->max_nack_rounds_ = max_nack_rounds_;
+        shard->receive_backend_type_ = receive_backend_type_;
+        shard->memory_budget_ = memory_budget_ / worker_count_;
+        shard->lost_frames_ = lost_frames_;
+        shard->busy_poll_budget_ = busy_poll_budget_;
+        shard->socket_busy_poll_ = socket_busy_poll_;
+        shard->udp_gro_ = udp_gro_;
+        shard->probing_ = prober_ && i == 0; // Probe echo'ları shard 0'a yönlenir
+        if (pin_to_cores_) {
+            shard->cpu_affinity_ = static_cast<int>(i % cores);
+        }
+        
+        // Soketler shard sırasıyla bağlanır, böylece reuseport grubundaki indeks = shard indeksi
+        if (!shard->initialize(tunnel_ips, tunnel_ports)) {
+            return false;
+        }
+        shards_.push_back(std::move(shard));
+    }
+    
+    // Her tünelin reuseport grubuna frame_id yönlendirmesini bağla
+    for (const auto& entry : shards_.front()->tunnel_to_socket_) {
+        if (!attach_shard_steering(entry.second, worker_count_)) {
+            LOG_ERROR("HATA: Reuseport cBPF bağlanamadı: %s", strerror(errno));
+            return false;
+        }
+    }
+    
+    LOG_INFO("✓ Reassembly Engine %zu shard ile başlatıldı", worker_count_);
+    return true;
+}
+
 bool ReassemblyEngine::initialize(const std::vector<std::string>& tunnel_ips, 
                                 const std::vector<int>& tunnel_ports) {
     if (tunnel_ips.size() != tunnel_ports.size()) {
-        std::cerr << "HATA: Tunnel IP ve port sayıları eşleşmiyor!" << std::endl;
+        LOG_ERROR("HATA: Tunnel IP ve port sayıları eşleşmiyor!");
         return false;
     }
     
+    if (worker_count_ > 1) {
+        return initialize_shards(tunnel_ips, tunnel_ports);
+    }
+    
+    // Tek worker ile sıralı teslim
+    if (!delivery_ && playout_delay_.count() > 0) {
+        create_delivery_stage(1, playout_delay_);
+        delivery_ = delivery_stage_.get();
+        shard_index_ = 0;
+    }
+    
+    // Tek worker: probe'ları bu engine gönderir (shard'lara prober üst engine'den verilir)
+    if (!prober_ && probe_interval_.count() > 0) {
+        tunnel_prober_ = std::make_unique<TunnelProber>(skew_percentile_);
+        prober_ = tunnel_prober_.get();
+        probing_ = true;
+    }
+    
     // Epoll oluştur
     epoll_fd_ = epoll_create1(0);
     if (epoll_fd_ < 0) {
-        std::cerr << "HATA: Epoll oluşturulamadı: " << strerror(errno) << std::endl;
+        LOG_ERROR("HATA: Epoll oluşturulamadı: %s", strerror(errno));
+        return false;
+    }
+    
+    // Eksik slice deadline'ları için timerfd oluştur ve epoll'e ekle
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ < 0) {
+        LOG_ERROR("HATA: Timerfd oluşturulamadı: %s", strerror(errno));
+        return false;
+    }
+    
+    struct epoll_event timer_ev;
+    timer_ev.events = EPOLLIN;
+    timer_ev.data.fd = timer_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &timer_ev) < 0) {
+        LOG_ERROR("HATA: Epoll'e timerfd eklenemedi: %s", strerror(errno));
         return false;
     }
     
@@ -48,7 +237,7 @@ bool ReassemblyEngine::initialize(const std::vector<std::string>& tunnel_ips,
     for (size_t i = 0; i < tunnel_ips.size(); ++i) {
         int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
         if (sock_fd < 0) {
-            std::cerr << "HATA: Socket oluşturulamadı: " << strerror(errno) << std::endl;
+            LOG_ERROR("HATA: Socket oluşturulamadı: %s", strerror(errno));
             return false;
         }
         
@@ -56,6 +245,20 @@ bool ReassemblyEngine::initialize(const std::vector<std::string>& tunnel_ips,
         int flags = fcntl(sock_fd, F_GETFL, 0);
         fcntl(sock_fd, F_SETFL, flags | O_NONBLOCK);
         
+        // Shard modunda aynı port her shard tarafından açılır
+        if (reuse_port_) {
+            int enable = 1;
+            if (setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+                LOG_ERROR("HATA: SO_REUSEPORT ayarlanamadı: %s", strerror(errno));
+                close(sock_fd);
+                return false;
+            }
+        }
+        
+        if (busy_poll_budget_.count() > 0) {
+            enable_socket_busy_poll(sock_fd);
+        }
+        
         // Bind
         struct sockaddr_in addr;
         memset(&addr, 0, sizeof(addr));
@@ -64,18 +267,7 @@ bool ReassemblyEngine::initialize(const std::vector<std::string>& tunnel_ips,
         addr.sin_addr.s_addr = inet_addr(tunnel_ips[i].c_str());
         
         if (bind(sock_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-            std::cerr << "HATA: Bind başarısız: " << strerror(errno) << std::endl;
-            close(sock_fd);
-            return false;
-        }
-        
-        // Epoll'e ekle
-        struct epoll_event ev;
-        ev.events = EPOLLIN;
-        ev.data.fd = sock_fd;
-        
-        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, sock_fd, &ev) < 0) {
-            std::cerr << "HATA: Epoll'e socket eklenemedi: " << strerror(errno) << std::endl;
+            LOG_ERROR("HATA: Bind başarısız: %s", strerror(errno));
             close(sock_fd);
             return false;
         }
@@ -86,13 +278,61 @@ bool ReassemblyEngine::initialize(const std::vector<std::string>& tunnel_ips,
         tunnel_to_socket_[tunnel_id] = sock_fd;
         
         // Tünel profilini oluştur
-        tunnels_[tunnel_id] = TunnelProfile{tunnel_id, 0, 0, 0, 0.0, std::chrono::steady_clock::now()};
+        tunnels_[tunnel_id] = TunnelProfile{tunnel_id, 0.0, std::chrono::steady_clock::now()};
+        if (probing_) {
+            prober_->add_tunnel(tunnel_id, sock_fd);
+        }
         
-        std::cout << "✓ Tunnel " << (int)tunnel_id << " başlatıldı: " 
-                  << tunnel_ips[i] << ":" << tunnel_ports[i] << std::endl;
+        if (!is_shard()) {
+            LOG_INFO("✓ Tunnel %d başlatıldı: %s:%d", (int)tunnel_id, tunnel_ips[i].c_str(), tunnel_ports[i]);
+        }
+    }
+    
+    // Soketleri alım backend'ine bağla
+    receiver_ = create_receive_backend(receive_backend_type_, epoll_fd_, socket_to_tunnel_,
+        [this](const ReceivedDatagram* datagrams, size_t count, std::chrono::steady_clock::time_point arrival_time) {
+            handle_datagrams(datagrams, count, arrival_time);
+        }, receive_options());
+    if (!receiver_) {
+        return false;
+    }
+    
+    if (probing_ && !start_probing()) {
+        return false;
+    }
+    
+    if (!is_shard()) {
+        LOG_INFO("✓ Reassembly Engine başlatıldı (%zu tunnel, %s)", tunnel_ips.size(), receiver_->name());
+    }
+    return true;
+}
+
+bool ReassemblyEngine::start_probing() {
+    // Periyodik probe timer'ı
+    probe_timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (probe_timer_fd_ < 0) {
+        LOG_ERROR("HATA: Probe timerfd oluşturulamadı: %s", strerror(errno));
+        return false;
     }
     
-    std::cout << "✓ Reassembly Engine başlatıldı (" << tunnel_ips.size() << " tunnel)" << std::endl;
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(probe_interval_).count();
+    spec.it_interval.tv_sec = ns / 1000000000;
+    spec.it_interval.tv_nsec = ns % 1000000000;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(probe_timer_fd_, 0, &spec, nullptr) < 0) {
+        LOG_ERROR("HATA: Probe timerfd ayarlanamadı: %s", strerror(errno));
+        return false;
+    }
+    
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = probe_timer_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, probe_timer_fd_, &ev) < 0) {
+        LOG_ERROR("HATA: Epoll'e probe timerfd eklenemedi: %s", strerror(errno));
+        return false;
+    }
     return true;
 }
 
@@ -100,250 +340,979 @@ void ReassemblyEngine::run() {
     if (running_) return;
     
     running_ = true;
+    
+    if (!shards_.empty()) {
+        delivery_stage_->start();
+        for (auto& shard : shards_) {
+            shard->run();
+        }
+        LOG_INFO("✓ Reassembly Engine çalışıyor (%zu shard)...", shards_.size());
+        return;
+    }
+    
+    if (delivery_stage_) {
+        delivery_stage_->start();
+    }
     worker_thread_ = std::thread(&ReassemblyEngine::worker_loop, this);
     
-    std::cout << "✓ Reassembly Engine çalışıyor..." << std::endl;
+    if (cpu_affinity_ >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu_affinity_, &cpus);
+        if (pthread_setaffinity_np(worker_thread_.native_handle(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARN("UYARI: Worker çekirdek %d'e sabitlenemedi", cpu_affinity_);
+        }
+    }
+    
+    if (!is_shard()) {
+        LOG_INFO("✓ Reassembly Engine çalışıyor...");
+    }
 }
 
 void ReassemblyEngine::stop() {
     if (!running_) return;
     
     running_ = false;
+    
+    if (!shards_.empty()) {
+        for (auto& shard : shards_) {
+            shard->stop();
+        }
+        delivery_stage_->stop();
+    }
+    
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
     
-    std::cout << "✓ Reassembly Engine durduruldu" << std::endl;
+    if (delivery_stage_ && shards_.empty()) {
+        delivery_stage_->stop();
+    }
+    
+    if (!is_shard()) {
+        LOG_INFO("✓ Reassembly Engine durduruldu");
+    }
 }
 
 void ReassemblyEngine::worker_loop() {
     const int MAX_EVENTS = 10;
     struct epoll_event events[MAX_EVENTS];
     
+    // io_uring istekleri worker thread'inden gönderilir (completion'lar bu thread'de işlenir)
+    if (!receiver_->arm() && !fall_back_to_epoll()) {
+        return;
+    }
+    
+    auto last_event = std::chrono::steady_clock::now();
     while (running_) {
-        int nfds = epoll_wait(epoll_fd_, events, MAX_EVENTS, 100); // 100ms timeout
+        int nfds = wait_for_events(events, MAX_EVENTS, last_event);
         
         if (nfds < 0) {
             if (errno == EINTR) continue; // Interrupt, devam et
-            std::cerr << "HATA: Epoll wait başarısız: " << strerror(errno) << std::endl;
+            LOG_ERROR("HATA: Epoll wait başarısız: %s", strerror(errno));
             break;
         }
         
         for (int i = 0; i < nfds; ++i) {
-            if (events[i].events & EPOLLIN) {
-                handle_socket_event(events[i].data.fd);
+            if (!(events[i].events & EPOLLIN)) continue;
+            
+            if (events[i].data.fd == timer_fd_) {
+                uint64_t expirations;
+                while (read(timer_fd_, &expirations, sizeof(expirations)) > 0) {}
+                process_deadlines(std::chrono::steady_clock::now());
+            } else if (events[i].data.fd == probe_timer_fd_) {
+                uint64_t expirations;
+                while (read(probe_timer_fd_, &expirations, sizeof(expirations)) > 0) {}
+                prober_->send_probes(probe_clock_ns());
+            } else if (receiver_->on_readable(events[i].data.fd) && !receiver_->healthy()) {
+                if (!fall_back_to_epoll()) return;
             }
         }
-        
-        // Eski frame'leri temizle
-        cleanup_old_frames();
     }
 }
 
-void ReassemblyEngine::handle_socket_event(int socket_fd) {
-    process_incoming_data(socket_fd);
+int ReassemblyEngine::wait_for_events(struct epoll_event* events, int max_events,
+                                      std::chrono::steady_clock::time_point& last_event) {
+    if (busy_poll_budget_.count() == 0) {
+        return epoll_wait(epoll_fd_, events, max_events, 100); // 100ms timeout
+    }
+    
+    // Spin: son olaydan sonra bütçe dolana kadar bloklamadan yokla
+    while (running_) {
+        int nfds = epoll_wait(epoll_fd_, events, max_events, 0);
+        metrics_.on_busy_poll(nfds == 0);
+        const auto now = std::chrono::steady_clock::now();
+        if (nfds != 0) {
+            last_event = now;
+            return nfds;
+        }
+        if (now - last_event >= busy_poll_budget_) break;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    
+    // Bütçe doldu: bir sonraki olaya kadar uyu
+    metrics_.on_blocking_wait();
+    int nfds = epoll_wait(epoll_fd_, events, max_events, 100);
+    last_event = std::chrono::steady_clock::now();
+    return nfds;
+}
+
+void ReassemblyEngine::enable_socket_busy_poll(int socket_fd) {
+    // Sysctl (net.core.busy_read) üzerindeki değerler CAP_NET_ADMIN gerektirir; hata spin'i engellemez
+    int busy_poll_us = static_cast<int>(socket_busy_poll_.count());
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) < 0) {
+        LOG_WARN("UYARI: SO_BUSY_POLL ayarlanamadı: %s", strerror(errno));
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer)) < 0) {
+        LOG_WARN("UYARI: SO_PREFER_BUSY_POLL ayarlanamadı: %s", strerror(errno));
+    }
+#endif
+}
+
+uint64_t ReassemblyEngine::worker_cpu_time_ns() {
+    if (!worker_thread_.joinable()) return 0;
+    
+    clockid_t clock;
+    struct timespec ts;
+    if (pthread_getcpuclockid(worker_thread_.native_handle(), &clock) != 0 ||
+        clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+ReceiveOptions ReassemblyEngine::receive_options() const {
+    ReceiveOptions options;
+    options.edge_triggered = busy_poll_budget_.count() > 0;
+    options.udp_gro = udp_gro_;
+    return options;
+}
+
+bool ReassemblyEngine::fall_back_to_epoll() {
+    LOG_WARN("UYARI: %s alımı çalışmıyor, epoll'e geçiliyor", receiver_->name());
+    receiver_ = create_receive_backend(ReceiveBackendType::EPOLL, epoll_fd_, socket_to_tunnel_,
+        [this](const ReceivedDatagram* datagrams, size_t count, std::chrono::steady_clock::time_point arrival_time) {
+            handle_datagrams(datagrams, count, arrival_time);
+        }, receive_options());
+    return receiver_ != nullptr;
 }
 
-void ReassemblyEngine::process_incoming_data(int socket_fd) {
-    uint8_t buffer[65536];
-    struct sockaddr_in client_addr;
-    socklen_t addr_len = sizeof(client_addr);
+void ReassemblyEngine::handle_datagrams(const ReceivedDatagram* datagrams, size_t count,
+                                        std::chrono::steady_clock::time_point arrival_time) {
+    TunnelProfile* tunnel = nullptr;
     
-    while (true) {
-        ssize_t bytes_received = recvfrom(socket_fd, buffer, sizeof(buffer), 0,
-                                         (struct sockaddr*)&client_addr, &addr_len);
+    for (size_t i = 0; i < count; ++i) {
+        const ReceivedDatagram& datagram = datagrams[i];
         
-        if (bytes_received < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                break; // Non-blocking, veri yok
-            }
-            std::cerr << "HATA: Recvfrom başarısız: " << strerror(errno) << std::endl;
-            break;
+        // Batch genelde tek tünelden gelir; profil araması tünel değiştiğinde yapılır
+        if (!tunnel || tunnel->tunnel_id != datagram.tunnel_id) {
+            tunnel = &tunnels_[datagram.tunnel_id];
         }
         
-        if (bytes_received < sizeof(SliceHeader)) {
-            std::cerr << "UYARI: Çok küçük paket alındı" << std::endl;
+        if (datagram.truncated) {
+            metrics_.on_invalid_slice();
+            LOG_WARN("UYARI: Alım buffer'ından büyük paket atıldı");
             continue;
         }
         
-        // Header'ı parse et
-        SliceHeader* header = reinterpret_cast<SliceHeader*>(buffer);
-        uint8_t tunnel_id = socket_to_tunnel_[socket_fd];
+        // Probe ve NACK'ler son datagramın kaynağına gider
+        const sockaddr_in& source = *datagram.source;
+        if (!tunnel->has_peer || tunnel->peer.sin_port != source.sin_port ||
+            tunnel->peer.sin_addr.s_addr != source.sin_addr.s_addr) {
+            tunnel->peer = source;
+            tunnel->has_peer = true;
+            if (probing_) {
+                prober_->observe_peer(datagram.tunnel_id, source);
+            }
+        }
         
-        // Slice bilgisini oluştur
-        SliceInfo slice;
-        slice.frame_id = ntohl(header->frame_id);
-        slice.slice_id = ntohs(header->slice_id);
-        slice.total_slices = ntohs(header->total_slices);
-        slice.tunnel_id = tunnel_id;
-        slice.arrival_time = std::chrono::steady_clock::now();
+        // UDP_GRO: birleşik datagram eşit boyutlu slice'lardan oluşur (son segment kısa olabilir)
+        const size_t segment_size = datagram.segment_size;
+        if (segment_size == 0 || datagram.length <= segment_size) {
+            process_datagram(datagram.data, datagram.length, datagram.tunnel_id, arrival_time);
+            continue;
+        }
         
-        // Data'yı kopyala
-        size_t data_size = bytes_received - sizeof(SliceHeader);
-        slice.data.assign(buffer + sizeof(SliceHeader), 
-                        buffer + sizeof(SliceHeader) + data_size);
+        const size_t segments = (datagram.length + segment_size - 1) / segment_size;
+        metrics_.on_coalesced(segments);
+        for (size_t offset = 0; offset < datagram.length; offset += segment_size) {
+            process_datagram(datagram.data + offset, std::min(segment_size, datagram.length - offset),
+                             datagram.tunnel_id, arrival_time);
+        }
+    }
+}
+
+void ReassemblyEngine::process_datagram(const uint8_t* buffer, size_t length, uint8_t tunnel_id,
+                                        std::chrono::steady_clock::time_point arrival_time) {
+    if (length < sizeof(SliceHeader)) {
+        LOG_WARN("UYARI: Çok küçük paket alındı");
+        return;
+    }
+    
+    // Header'ı parse et
+    const SliceHeader* header = reinterpret_cast<const SliceHeader*>(buffer);
+    
+    // total_slices = 0 veri slice'ı olamaz; probe echo'su olabilir
+    if (header->total_slices == 0 && TunnelProber::is_probe(buffer, length)) {
+        handle_probe_packet(buffer, length, tunnel_id, arrival_time);
+        return;
+    }
+    
+    // Slice bilgisini oluştur (veri slab'da kalır, kopyalanmaz)
+    SliceInfo slice;
+    slice.frame_id = ntohl(header->frame_id);
+    slice.slice_id = ntohs(header->slice_id);
+    slice.total_slices = ntohs(header->total_slices);
+    slice.tunnel_id = tunnel_id;
+    slice.data = buffer + sizeof(SliceHeader);
+    slice.data_size = length - sizeof(SliceHeader);
+    slice.arrival_time = arrival_time;
+    slice.is_parity = (header->reserved & SLICE_FLAG_PARITY) != 0;
+    slice.fec_parity = header->reserved & SLICE_FEC_PARITY_MASK;
+    slice.frame_flags = header->frame_flags;
+    slice.reference_id = slice.frame_id - header->reference_distance;
+    
+    // Slice'ı işle
+    process_slice(slice);
+}
+
+void ReassemblyEngine::handle_probe_packet(const uint8_t* buffer, size_t length, uint8_t tunnel_id,
+                                           std::chrono::steady_clock::time_point arrival_time) {
+    if (!probing_) return;
+    
+    const uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        arrival_time.time_since_epoch()).count();
+    double rtt_ms = 0.0;
+    if (prober_->handle_packet(tunnel_id, buffer, length, now_ns, rtt_ms)) {
+        // Ölçülen RTT tünel profiline de işlenir
+        auto it = tunnels_.find(tunnel_id);
+        if (it != tunnels_.end()) {
+            it->second.update_rtt(rtt_ms);
+        }
+        LOG_DEBUG("📡 Tunnel %d RTT %.2fms", (int)tunnel_id, rtt_ms);
+    }
+}
+
+FrameState* ReassemblyEngine::acquire_frame(const SliceInfo& slice) {
+    if (slice.total_slices == 0 || slice.total_slices > MAX_SLICES_PER_FRAME) {
+        metrics_.on_invalid_slice();
+        return nullptr; // Geçersiz slice başlığı
+    }
+    
+    const uint16_t parity_slices = FecCodec::parity_slice_count(slice.total_slices, slice.fec_parity);
+    if (parity_slices > FEC_MAX_PARITY_SLICES ||
+        slice.slice_id >= (slice.is_parity ? parity_slices : slice.total_slices)) {
+        metrics_.on_invalid_slice();
+        return nullptr; // Geçersiz slice/parity indeksi
+    }
+    if ((slice.frame_flags & FRAME_FLAG_DEPENDENT) && slice.reference_id == slice.frame_id) {
+        metrics_.on_invalid_slice();
+        return nullptr; // Frame kendisine bağımlı olamaz
+    }
+    
+    auto& frame = frame_slot(slice.frame_id);
+    
+    if (frame.frame_id == slice.frame_id) {
+        if (!frame.in_use && (frame.completed || frame.discarded)) {
+            metrics_.on_late_slice();
+            return nullptr; // Zaten teslim edilmiş/atılmış frame'e geç gelen slice
+        }
+    } else if (frame.in_use) {
+        if (!frame_id_newer(slice.frame_id, frame.frame_id)) {
+            metrics_.on_late_slice();
+            return nullptr; // Pencerenin gerisinde kalmış slice
+        }
         
-        // Slice'ı işle
-        process_slice(slice);
+        // Pencere kaydı: eski frame tamamlanmadan slot yeni frame'e veriliyor
+        LOG_INFO("🗑️ Frame %u pencereden düştü", frame.frame_id);
+        discard_frame(frame);
+    }
+    
+    if (!frame.in_use) {
+        frame.reset(slice.frame_id, slice.total_slices, slice.fec_parity, slice.arrival_time);
+        frame.frame_flags = slice.frame_flags;
+        frame.reference_id = slice.reference_id;
+        frame.priority = classify_frame(slice);
         
-        // Tünel istatistiklerini güncelle
-        tunnels_[tunnel_id].received_packets++;
+        // Referansı zaten atılmış frame çözülemez; slice'ları hiç birleştirilmez
+        if (is_undecodable(frame)) {
+            drop_undecodable(frame);
+            return nullptr;
+        }
+        schedule_frame_expiry(frame);
+    } else if (frame.total_slices != slice.total_slices ||
+               frame.fec_parity_per_block != slice.fec_parity ||
+               frame.frame_flags != slice.frame_flags) {
+        metrics_.on_invalid_slice();
+        return nullptr; // Aynı frame için tutarsız slice/FEC/tür bilgisi
+    }
+    
+    return &frame;
+}
+
+void ReassemblyEngine::release_frame(FrameState& frame) {
+    // Frame buffer'ı havuza döner, slotun pending_tail kapasitesi korunur
+    if (!frame.buffer.empty()) {
+        frame_pool_->release(std::move(frame.buffer));
+        frame.buffer = std::vector<uint8_t>();
+    }
+    if (frame.memory_bytes > 0) {
+        frame_memory_bytes_ -= frame.memory_bytes;
+        frame.memory_bytes = 0;
+        metrics_.set_frame_memory(frame_memory_bytes_);
+    }
+    frame.in_use = false;
+}
+
+FramePriority ReassemblyEngine::classify_frame(const SliceInfo& slice) {
+    if (slice.frame_flags & FRAME_FLAG_KEYFRAME) return FramePriority::KEYFRAME;
+    if (slice.frame_flags & FRAME_FLAG_REFERENCE) return FramePriority::REFERENCE;
+    if (slice.frame_flags != 0) return FramePriority::NON_REFERENCE;
+    
+    // Tür bilgisi olmadan ortalamanın çok üzerindeki frame keyframe kabul edilir
+    if (average_frame_slices_ > 0.0 && slice.total_slices > average_frame_slices_ * KEYFRAME_SIZE_RATIO) {
+        return FramePriority::KEYFRAME;
+    }
+    average_frame_slices_ = average_frame_slices_ == 0.0
+        ? slice.total_slices
+        : average_frame_slices_ * 0.9 + slice.total_slices * 0.1;
+    return FramePriority::REFERENCE;
+}
+
+bool ReassemblyEngine::reserve_frame_memory(FrameState& frame, size_t bytes) {
+    if (memory_budget_ == 0) return true;
+    
+    if (bytes > memory_budget_) {
+        LOG_WARN("UYARI: Frame %u (%zu byte) bellek bütçesini aşıyor", frame.frame_id, bytes);
+        evict_frame(frame);
+        return false;
+    }
+    
+    while (frame_memory_bytes_ + bytes > memory_budget_) {
+        FrameState* victim = select_eviction_victim(frame);
+        if (!victim) {
+            // Kuyruktaki tüm frame'ler yeni frame'den önemli
+            evict_frame(frame);
+            return false;
+        }
+        evict_frame(*victim);
+        if (!frame.in_use) {
+            return false; // Frame'in referansı atıldı
+        }
+    }
+    return true;
+}
+
+FrameState* ReassemblyEngine::select_eviction_victim(const FrameState& incoming) {
+    // En düşük öncelikli, aynı öncelikte en eski frame (bütçe aşımında, pencere boyunca tarama)
+    FrameState* victim = nullptr;
+    for (auto& frame : frames_) {
+        if (!frame.in_use || frame.memory_bytes == 0 || &frame == &incoming) continue;
+        if (!victim || frame.priority < victim->priority ||
+            (frame.priority == victim->priority && frame.first_slice_time < victim->first_slice_time)) {
+            victim = &frame;
+        }
+    }
+    if (victim && victim->priority > incoming.priority) {
+        return nullptr;
+    }
+    return victim;
+}
+
+bool ReassemblyEngine::is_undecodable(const FrameState& frame) const {
+    return frame.depends_on_reference() && lost_frames_->contains(frame.reference_id);
+}
+
+void ReassemblyEngine::drop_undecodable(FrameState& frame) {
+    LOG_DEBUG("⛓️ Frame %u referansı (%u) kayıp, çözülemez frame atılıyor", frame.frame_id, frame.reference_id);
+    metrics_.on_frame_undecodable();
+    discard_frame(frame);
+}
+
+void ReassemblyEngine::drop_dependents(uint32_t reference_id) {
+    // Atılan referansa bağımlı, birleştirilmekte olan frame'ler (atılanlar da referanssa zincir devam eder)
+    for (auto& frame : frames_) {
+        if (frame.in_use && frame.depends_on_reference() && frame.reference_id == reference_id) {
+            drop_undecodable(frame);
+        }
+    }
+}
+
+void ReassemblyEngine::evict_frame(FrameState& frame) {
+    LOG_INFO("🧹 Frame %u bellek bütçesi için atıldı (%zu byte)", frame.frame_id, frame.memory_bytes);
+    metrics_.on_frame_evicted();
+    discard_frame(frame);
+}
+
+void ReassemblyEngine::submit_result(FrameState& frame, std::vector<uint8_t>&& data) {
+    CompletedFrame result;
+    result.frame_id = frame.frame_id;
+    result.discarded = frame.discarded;
+    result.data = std::move(data);
+    result.pool = frame_pool_;
+    result.first_slice_time = frame.first_slice_time;
+    result.completed_time = std::chrono::steady_clock::now();
+    
+    // Kuyruk doluysa frame atılır; teslim aşaması boşluğu playout deadline'ında atlar
+    if (!delivery_->push(shard_index_, std::move(result))) {
+        LOG_WARN("UYARI: Teslim kuyruğu dolu, frame %u atıldı", frame.frame_id);
+        frame_pool_->release(std::move(result.data));
+    }
+}
+
+void ReassemblyEngine::discard_frame(FrameState& frame) {
+    frame.discarded = true;
+    metrics_.on_frame_discard();
+    release_frame(frame);
+    
+    if (delivery_) {
+        submit_result(frame, std::vector<uint8_t>());
+    } else if (frame_discard_callback_) {
+        frame_discard_callback_(frame.frame_id);
+    }
+    
+    // Referans olmayan frame'e bağımlı frame yoktur
+    if (frame.priority != FramePriority::NON_REFERENCE) {
+        lost_frames_->mark(frame.frame_id);
+        drop_dependents(frame.frame_id);
     }
 }
 
+bool ReassemblyEngine::ensure_frame_buffer(FrameState& frame, uint32_t stride) {
+    if (frame.slice_stride != 0) {
+        return stride == frame.slice_stride;
+    }
+    if (stride == 0 || frame.pending_tail.size() > stride) {
+        return false;
+    }
+    
+    // İlk tam slice stride'ı belirler; buffer veri + parity bölgesi için en kötü durum boyutuyla alınır
+    const size_t buffer_size = static_cast<size_t>(frame.total_slices + frame.parity_slices) * stride;
+    if (!reserve_frame_memory(frame, buffer_size)) {
+        return false; // Frame bütçe için atıldı
+    }
+    frame.slice_stride = stride;
+    frame.buffer = frame_pool_->acquire(buffer_size);
+    frame.memory_bytes = frame.buffer.size();
+    frame_memory_bytes_ += frame.memory_bytes;
+    metrics_.set_frame_memory(frame_memory_bytes_);
+    
+    if (!frame.pending_tail.empty()) {
+        std::memcpy(frame.buffer.data() + static_cast<size_t>(frame.total_slices - 1) * stride,
+                    frame.pending_tail.data(), frame.pending_tail.size());
+        frame.pending_tail.clear();
+    }
+    return true;
+}
+
+bool ReassemblyEngine::place_slice(FrameState& frame, const SliceInfo& slice) {
+    const bool is_last = slice.slice_id == frame.total_slices - 1;
+    
+    if (frame.slice_stride == 0) {
+        if (is_last && frame.total_slices > 1) {
+            // Stride henüz bilinmiyor, son slice'ı geçici olarak sakla
+            frame.pending_tail.assign(slice.data, slice.data + slice.data_size);
+            frame.last_slice_size = static_cast<uint32_t>(slice.data_size);
+            return true;
+        }
+        if (!ensure_frame_buffer(frame, static_cast<uint32_t>(slice.data_size))) {
+            return false;
+        }
+    }
+    
+    // Son slice hariç tüm slice'lar stride boyutunda olmalı
+    if (is_last ? slice.data_size > frame.slice_stride : slice.data_size != frame.slice_stride) {
+        return false;
+    }
+    
+    std::memcpy(frame.buffer.data() + static_cast<size_t>(slice.slice_id) * frame.slice_stride,
+                slice.data, slice.data_size);
+    if (is_last) {
+        frame.last_slice_size = static_cast<uint32_t>(slice.data_size);
+    }
+    return true;
+}
+
+bool ReassemblyEngine::place_parity_slice(FrameState& frame, const SliceInfo& slice) {
+    // Parity payload: [frame boyutu (4 byte)] [stride byte parity]
+    if (slice.data_size <= FEC_PARITY_PREFIX_SIZE) {
+        return false;
+    }
+    const uint32_t stride = static_cast<uint32_t>(slice.data_size - FEC_PARITY_PREFIX_SIZE);
+    if (!ensure_frame_buffer(frame, stride)) {
+        return false;
+    }
+    
+    // Frame boyutu son slice'ın boyutunu verir (son slice kaybolsa bile)
+    uint32_t frame_size_be;
+    std::memcpy(&frame_size_be, slice.data, sizeof(frame_size_be));
+    const size_t frame_size = ntohl(frame_size_be);
+    const size_t head_size = static_cast<size_t>(frame.total_slices - 1) * stride;
+    if (frame_size <= head_size || frame_size > head_size + stride) {
+        return false;
+    }
+    const uint32_t last_size = static_cast<uint32_t>(frame_size - head_size);
+    if (frame.has_slice(frame.total_slices - 1) && frame.last_slice_size != last_size) {
+        return false;
+    }
+    frame.last_slice_size = last_size;
+    
+    std::memcpy(frame.buffer.data() + static_cast<size_t>(frame.total_slices + slice.slice_id) * stride,
+                slice.data + FEC_PARITY_PREFIX_SIZE, stride);
+    return true;
+}
+
 void ReassemblyEngine::process_slice(const SliceInfo& slice) {
-    auto& frame = frames_[slice.frame_id];
-    
-    // İlk slice ise frame'i başlat
-    if (frame.slices.empty()) {
-        frame.frame_id = slice.frame_id;
-        frame.total_slices = slice.total_slices;
-        frame.received_slices = 0;
-        frame.first_slice_time = slice.arrival_time;
-        frame.fec_applied = false;
-        frame.discarded = false;
-    }
-    
-    // Slice'ı ekle (eğer yoksa)
-    if (frame.slices.find(slice.slice_id) == frame.slices.end()) {
-        frame.slices[slice.slice_id] = slice;
-        frame.received_slices++;
+    if (!shards_.empty()) {
+        shards_[slice.frame_id % shards_.size()]->process_slice(slice);
+        return;
+    }
+    
+    FrameState* frame_ptr = acquire_frame(slice);
+    if (!frame_ptr) return;
+    auto& frame = *frame_ptr;
+    metrics_.on_slice(slice.tunnel_id, slice.data_size, slice.is_parity);
+    
+    if (slice.is_parity) {
+        // Parity slice'ı frame buffer'ının parity bölgesine yerleştir
+        if (!frame.has_parity(slice.slice_id)) {
+            if (!place_parity_slice(frame, slice)) {
+                if (frame.in_use) {
+                    LOG_WARN("UYARI: Frame %u Parity %u tutarsız, frame atılıyor", slice.frame_id, slice.slice_id);
+                    discard_frame(frame);
+                }
+                return;
+            }
+            frame.mark_parity(slice.slice_id);
+            frame.last_slice_time = slice.arrival_time;
+        } else {
+            metrics_.on_duplicate(slice.tunnel_id);
+        }
+    } else if (!frame.has_slice(slice.slice_id)) {
+        // Slice'ı ekle (eğer yoksa)
+        // Slab'dan frame buffer'ındaki son konumuna tek kopya
+        if (!place_slice(frame, slice)) {
+            if (frame.in_use) {
+                LOG_WARN("UYARI: Frame %u Slice %u boyutu tutarsız, frame atılıyor", slice.frame_id, slice.slice_id);
+                discard_frame(frame);
+            }
+            return;
+        }
+        // Sıra dışılık derinliği: bu slice'tan sonraki kaç slice önce geldi
+        if (frame.received_slices > 0 && slice.slice_id < frame.highest_slice_id) {
+            metrics_.on_out_of_order(slice.tunnel_id, frame.highest_slice_id - slice.slice_id);
+        }
+        frame.highest_slice_id = std::max(frame.highest_slice_id, slice.slice_id);
+        frame.mark_slice(slice.slice_id);
         frame.last_slice_time = slice.arrival_time;
         
-        std::cout << "📦 Frame " << slice.frame_id << " Slice " << (int)slice.slice_id 
-                  << "/" << frame.total_slices << " (Tunnel " << (int)slice.tunnel_id << ")" << std::endl;
+        LOG_DEBUG("📦 Frame %u Slice %u/%u (Tunnel %d)", slice.frame_id, slice.slice_id,
+                  frame.total_slices, (int)slice.tunnel_id);
+    } else {
+        metrics_.on_duplicate(slice.tunnel_id);
     }
     
-    // Frame tamamlandı mı kontrol et
-    if (frame.is_complete()) {
+    // Frame tamamlandı mı kontrol et (her blokta yeterli parity varsa beklemeden FEC ile kurtar;
+    // blok açıkları slice geldikçe güncellenir, çözüm yalnızca açık kapandığında denenir)
+    if (frame.is_complete() ||
+        (frame.fec_recoverable() && !frame.fec_failed && apply_fec_recovery(frame))) {
         handle_frame_completion(slice.frame_id);
-    } else {
-        // Eksik slice'lar için adaptif bekleme
-        auto missing = frame.get_missing_slices();
-        if (!missing.empty()) {
-            std::cout << "⏳ Frame " << slice.frame_id << " eksik: " 
-                      << missing.size() << " slice" << std::endl;
-            wait_for_missing_slices(frame);
-        }
+    } else if (!frame.deadline_armed) {
+        // Eksik slice'lar için adaptif bekleme (bloklamadan, deadline ile)
+        LOG_DEBUG("⏳ Frame %u eksik: %zu slice", slice.frame_id, (size_t)frame.get_missing_count());
+        schedule_frame_deadline(frame);
     }
 }
 
-void ReassemblyEngine::wait_for_missing_slices(FrameState& frame) {
+void ReassemblyEngine::observe_frame_span(const FrameState& frame) {
+    // Tamamlanan frame'in ortalama slice varış aralığı (EWMA). Batch alımında slice'lar aynı
+    // zaman damgasını paylaştığı için tek tek aralıklar değil frame'in toplam süresi kullanılır;
+    // NACK'lenen frame'lerde yalnızca ilk NACK'e kadar gelenler sayılır (yeniden gönderim hariç).
+    const bool nacked = frame.nack_rounds > 0;
+    const size_t arrived = nacked ? frame.pre_nack_slices
+                                  : static_cast<size_t>(frame.received_slices) + frame.received_parity;
+    if (arrived < 2) return;
+    const auto last_arrival = nacked ? frame.pre_nack_time : frame.last_slice_time;
+    const double span_us = std::chrono::duration<double, std::micro>(last_arrival - frame.first_slice_time).count();
+    const double interval_us = span_us / static_cast<double>(arrived - 1);
+    slice_interval_us_ = slice_interval_us_ == 0.0 ? interval_us : slice_interval_us_ + (interval_us - slice_interval_us_) / 8.0;
+}
+
+std::chrono::microseconds ReassemblyEngine::expected_frame_span(const FrameState& frame) const {
+    const size_t slices = static_cast<size_t>(frame.total_slices) + frame.parity_slices;
+    return std::chrono::microseconds(static_cast<int64_t>(slice_interval_us_ * (slices > 0 ? slices - 1 : 0)));
+}
+
+void ReassemblyEngine::schedule_frame_deadline(FrameState& frame) {
     auto wait_time = calculate_adaptive_wait_time(frame);
-    auto start_time = std::chrono::steady_clock::now();
+    frame.deadline = frame.first_slice_time + wait_time;
+    frame.deadline_armed = true;
+    deadlines_.push(FrameDeadline{frame.deadline, frame.frame_id});
     
-    std::cout << "🔄 Frame " << frame.frame_id << " için " 
-              << wait_time.count() << "ms bekleme..." << std::endl;
+    LOG_DEBUG("🔄 Frame %u için %lldms bekleme...", frame.frame_id, (long long)wait_time.count());
     
-    while (std::chrono::steady_clock::now() - start_time < wait_time) {
-        if (frame.is_complete()) {
-            std::cout << "✅ Frame " << frame.frame_id << " tamamlandı!" << std::endl;
-            handle_frame_completion(frame.frame_id);
-            return;
-        }
+    if (armed_deadline_ == std::chrono::steady_clock::time_point{} || frame.deadline < armed_deadline_) {
+        arm_deadline_timer();
+    }
+}
+
+bool ReassemblyEngine::is_deadline_live(const FrameDeadline& entry) {
+    const auto& frame = frame_slot(entry.frame_id);
+    return frame.in_use && frame.frame_id == entry.frame_id &&
+           frame.deadline_armed && frame.deadline == entry.deadline;
+}
+
+bool ReassemblyEngine::is_expiry_live(const FrameDeadline& entry) {
+    const auto& frame = frame_slot(entry.frame_id);
+    return frame.in_use && frame.frame_id == entry.frame_id && frame.expire_at == entry.deadline;
+}
+
+void ReassemblyEngine::schedule_frame_expiry(FrameState& frame) {
+    frame.expire_at = frame.first_slice_time + frame_expiry_age();
+    expiries_.push(FrameDeadline{frame.expire_at, frame.frame_id});
+    
+    if (armed_deadline_ == std::chrono::steady_clock::time_point{} || frame.expire_at < armed_deadline_) {
+        arm_deadline_timer();
+    }
+}
+
+void ReassemblyEngine::expire_frames(std::chrono::steady_clock::time_point now) {
+    // Yalnızca süresi dolan kayıtlar gezilir (tamamlanan frame'lerin kayıtları tembel silinir)
+    while (!expiries_.empty() && expiries_.top().deadline <= now) {
+        FrameDeadline entry = expiries_.top();
+        expiries_.pop();
+        
+        if (!is_expiry_live(entry)) continue;
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto& frame = frame_slot(entry.frame_id);
+        LOG_INFO("🗑️ Eski frame %u temizlendi", frame.frame_id);
+        discard_frame(frame);
+    }
+}
+
+void ReassemblyEngine::arm_deadline_timer() {
+    // Tamamlanmış/atılmış frame'lere ait kayıtları at
+    while (!deadlines_.empty() && !is_deadline_live(deadlines_.top())) {
+        deadlines_.pop();
+    }
+    while (!expiries_.empty() && !is_expiry_live(expiries_.top())) {
+        expiries_.pop();
+    }
+    
+    // En yakın deadline veya yaş sınırı
+    auto next = std::chrono::steady_clock::time_point{};
+    if (!deadlines_.empty()) next = deadlines_.top().deadline;
+    if (!expiries_.empty() && (next == std::chrono::steady_clock::time_point{} || expiries_.top().deadline < next)) {
+        next = expiries_.top().deadline;
+    }
+    if (next == armed_deadline_ || timer_fd_ < 0) return;
+    armed_deadline_ = next;
+    
+    // Sıfır değer timer'ı kapatır; steady_clock Linux'ta CLOCK_MONOTONIC'tir
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (next != std::chrono::steady_clock::time_point{}) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(next.time_since_epoch()).count();
+        if (ns <= 0) ns = 1;
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+    }
+    
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        LOG_ERROR("HATA: Timerfd ayarlanamadı: %s", strerror(errno));
+    }
+}
+
+void ReassemblyEngine::process_deadlines(std::chrono::steady_clock::time_point now) {
+    for (auto& shard : shards_) {
+        shard->process_deadlines(now);
+    }
+    
+    while (!deadlines_.empty() && deadlines_.top().deadline <= now) {
+        FrameDeadline entry = deadlines_.top();
+        deadlines_.pop();
+        
+        if (!is_deadline_live(entry)) continue;
+        
+        auto& frame = frame_slot(entry.frame_id);
+        frame.deadline_armed = false;
+        handle_frame_deadline(frame, now);
+    }
+    
+    expire_frames(now);
+    
+    armed_deadline_ = std::chrono::steady_clock::time_point{};
+    arm_deadline_timer();
+}
+
+void ReassemblyEngine::handle_frame_deadline(FrameState& frame, std::chrono::steady_clock::time_point now) {
+    if (frame.is_complete()) {
+        handle_frame_completion(frame.frame_id);
+        return;
+    }
+    
+    // Referans başka shard'da atılmış olabilir; FEC ve NACK'e gerek yok
+    if (is_undecodable(frame)) {
+        drop_undecodable(frame);
+        return;
     }
     
     // Süre doldu, FEC dene
-    if (!frame.is_complete() && !frame.fec_applied) {
-        std::cout << "🔧 Frame " << frame.frame_id << " için FEC uygulanıyor..." << std::endl;
+    if (!frame.fec_applied) {
+        LOG_DEBUG("🔧 Frame %u için FEC uygulanıyor...", frame.frame_id);
+        frame.fec_applied = true;
         if (apply_fec_recovery(frame)) {
             handle_frame_completion(frame.frame_id);
             return;
         }
     }
     
-    // FEC de başarısız, frame'i at
-    if (!frame.is_complete()) {
-        std::cout << "❌ Frame " << frame.frame_id << " atılıyor!" << std::endl;
-        frame.discarded = true;
-        if (frame_discard_callback_) {
-            frame_discard_callback_(frame.frame_id);
-        }
+    // Zaman varsa eksik slice'ları göndericiden iste
+    if (request_retransmission(frame, now)) {
+        return;
     }
+    
+    // FEC de başarısız, frame'i at
+    LOG_INFO("❌ Frame %u atılıyor!", frame.frame_id);
+    discard_frame(frame);
 }
 
-std::chrono::milliseconds ReassemblyEngine::calculate_adaptive_wait_time(const FrameState& frame) {
+bool ReassemblyEngine::measure_path_skew(const FrameState& frame, std::chrono::microseconds& skew) {
+    // Keyframe kaybı sonraki tüm frame'leri çözülemez yapar; daha uzun beklenir
+    const int factor = frame.priority == FramePriority::KEYFRAME ? KEYFRAME_WAIT_FACTOR : 1;
+    
+    // Ölçülen tek yön gecikme farkı yüzdeliği (probe echo'ları yeterliyse)
+    if (prober_) {
+        const auto measured = prober_->wait_time();
+        if (measured.count() > 0) {
+            skew = measured * factor;
+            return true;
+        }
+    }
+    
+    // Yedek: elle verilen RTT'lerin farkı
     double max_rtt = get_max_rtt();
     double min_rtt = get_min_rtt();
     
     if (max_rtt == 0.0 || min_rtt == 0.0) {
+        return false;
+    }
+    
+    // 2x RTT farkı
+    skew = std::chrono::microseconds(static_cast<int64_t>((max_rtt - min_rtt) * 2 * 1000)) * factor;
+    return true;
+}
+
+std::chrono::milliseconds ReassemblyEngine::calculate_adaptive_wait_time(const FrameState& frame) {
+    std::chrono::microseconds skew;
+    if (!measure_path_skew(frame, skew)) {
         return max_wait_time_; // Varsayılan
     }
     
-    // RTT farkına göre adaptif bekleme
-    double rtt_diff = max_rtt - min_rtt;
-    auto adaptive_wait = std::chrono::milliseconds(static_cast<int>(rtt_diff * 2)); // 2x RTT farkı
+    // Frame'in kendi gönderim süresi (ilk slice'tan son slice'ın beklenen varışına kadar);
+    // tüneller arası fark buna eklenir, yerine geçmez (tek/eşit yolda fark ~0)
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(skew + expected_frame_span(frame));
     
     // Sınırlar içinde tut
-    if (adaptive_wait < min_wait_time_) adaptive_wait = min_wait_time_;
-    if (adaptive_wait > max_wait_time_) adaptive_wait = max_wait_time_;
-    
-    return adaptive_wait;
+    return std::min(std::max(wait, min_wait_time_), max_wait_time_);
 }
 
 void ReassemblyEngine::handle_frame_completion(uint32_t frame_id) {
-    auto it = frames_.find(frame_id);
-    if (it == frames_.end()) return;
+    auto& frame = frame_slot(frame_id);
+    if (!frame.in_use || frame.frame_id != frame_id) return;
     
-    const auto& frame = it->second;
+    // Birleştirme sürerken referansı başka shard'da atılmış olabilir
+    if (is_undecodable(frame)) {
+        drop_undecodable(frame);
+        return;
+    }
     
     if (frame.is_complete() && !frame.discarded) {
-        // Frame'i yeniden oluştur
-        auto frame_data = reconstruct_frame(frame);
+        // Slice'lar zaten yerinde; buffer'ı gerçek boyuta indir (yeniden allocation yok)
+        std::vector<uint8_t> frame_data = std::move(frame.buffer);
+        frame.buffer = std::vector<uint8_t>();
+        frame_data.resize(frame.frame_size());
+        
+        LOG_DEBUG("🎯 Frame %u tamamlandı (%zu bytes)", frame_id, frame_data.size());
+        
+        metrics_.on_frame_complete(frame.last_slice_time - frame.first_slice_time);
+        observe_frame_span(frame);
+        if (frame.nack_rounds > 0) {
+            metrics_.on_frame_retransmit_recovered();
+        }
+        
+        // Slotu callback'ten önce serbest bırak
+        frame.completed = true;
+        release_frame(frame);
         
-        std::cout << "🎯 Frame " << frame_id << " tamamlandı (" 
-                  << frame_data.size() << " bytes)" << std::endl;
+        // Sıralı teslimde teslim aşamasına ilet (buffer oradan havuza döner)
+        if (delivery_) {
+            submit_result(frame, std::move(frame_data));
+            return;
+        }
         
         // Callback çağır
+        metrics_.on_frame_delivered(std::chrono::steady_clock::now() - frame.first_slice_time);
+        if (frame_handle_callback_) {
+            // Buffer handle ile birlikte gider, handle bırakıldığında havuza döner
+            frame_handle_callback_(FrameHandle(frame_id, std::move(frame_data), frame_pool_));
+            return;
+        }
         if (frame_complete_callback_) {
             frame_complete_callback_(frame_id, frame_data);
         }
         
-        // Frame'i temizle
-        frames_.erase(it);
+        // Buffer'ı havuza geri ver
+        frame_pool_->release(std::move(frame_data));
     }
 }
 
 bool ReassemblyEngine::apply_fec_recovery(FrameState& frame) {
-    // TODO: ISA-L FEC implementasyonu
-    // Şimdilik basit bir placeholder
-    std::cout << "🔧 FEC recovery uygulanıyor (placeholder)" << std::endl;
-    frame.fec_applied = true;
-    return false; // Şimdilik başarısız
+    // Kurtarma için her blokta kayıp kadar parity ve bilinen bir frame boyutu gerekir
+    if (!frame.fec_recoverable() || frame.slice_stride == 0 || frame.last_slice_size == 0) {
+        return false;
+    }
+    
+    const size_t stride = frame.slice_stride;
+    const size_t data_region = static_cast<size_t>(frame.total_slices) * stride;
+    uint8_t* buffer = frame.buffer.data();
+    
+    // Son slice'ın stride'a kadar olan dolgusu sıfır olmalı
+    if (frame.has_slice(frame.total_slices - 1)) {
+        const size_t tail = static_cast<size_t>(frame.total_slices - 1) * stride + frame.last_slice_size;
+        std::memset(buffer + tail, 0, data_region - tail);
+    }
+    
+    const uint16_t missing = frame.get_missing_count();
+    if (!fec_codec_.recover(buffer, buffer + data_region, frame.slice_stride, frame.total_slices,
+                            frame.fec_parity_per_block, frame.received_mask.data(), frame.parity_mask.data())) {
+        frame.fec_failed = true;
+        return false;
+    }
+    
+    // Kurtarılan slice'ları alındı olarak işaretle
+    frame.for_each_missing_slice([&frame](uint16_t slice_id) { frame.mark_slice(slice_id); });
+    
+    metrics_.on_frame_recovered(missing);
+    LOG_INFO("🔧 Frame %u FEC ile kurtarıldı (%zu slice)", frame.frame_id, (size_t)missing);
+    return true;
 }
 
-std::vector<uint8_t> ReassemblyEngine::reconstruct_frame(const FrameState& frame) {
-    std::vector<uint8_t> frame_data;
+bool ReassemblyEngine::select_nack_tunnel(uint8_t& tunnel_id, std::chrono::microseconds& timeout) {
+    // Probe ölçümü varsa en hızlı tünel
+    if (prober_ && prober_->fastest_tunnel(tunnel_id, timeout)) {
+        auto it = tunnels_.find(tunnel_id);
+        return it != tunnels_.end() && it->second.has_peer;
+    }
     
-    // Slice'ları sırayla birleştir
-    for (uint16_t i = 0; i < frame.total_slices; ++i) {
-        auto it = frame.slices.find(i);
-        if (it != frame.slices.end()) {
-            frame_data.insert(frame_data.end(), 
-                            it->second.data.begin(), 
-                            it->second.data.end());
+    // Yedek: elle verilen RTT'ler
+    const TunnelProfile* best = nullptr;
+    for (const auto& entry : tunnels_) {
+        const auto& tunnel = entry.second;
+        if (tunnel.has_peer && tunnel.avg_rtt_ms > 0.0 && (!best || tunnel.avg_rtt_ms < best->avg_rtt_ms)) {
+            best = &tunnel;
         }
     }
-    
-    return frame_data;
+    if (!best) return false;
+    tunnel_id = best->tunnel_id;
+    timeout = std::chrono::microseconds(static_cast<int64_t>((best->avg_rtt_ms + 4 * best->rtt_var_ms) * 1000));
+    return true;
 }
 
-void ReassemblyEngine::update_tunnel_rtt(uint8_t tunnel_id, double rtt_ms) {
-    auto it = tunnels_.find(tunnel_id);
-    if (it != tunnels_.end()) {
-        it->second.update_rtt(rtt_ms);
+bool ReassemblyEngine::request_retransmission(FrameState& frame, std::chrono::steady_clock::time_point now) {
+    if (!retransmission_enabled_ || frame.nack_rounds >= max_nack_rounds_) {
+        return false;
+    }
+    
+    uint8_t tunnel_id;
+    std::chrono::microseconds timeout;
+    if (!select_nack_tunnel(tunnel_id, timeout)) {
+        return false;
+    }
+    
+    // Yanıt frame bütçesine yetişmeyecekse isteme (keyframe'ler yaş sınırına kadar bekleyebilir)
+    const auto deadline = now + std::max<std::chrono::microseconds>(timeout, PROBE_WAIT_GUARD);
+    const auto budget = frame.priority == FramePriority::KEYFRAME ? frame.expire_at
+                                                                   : frame.first_slice_time + max_wait_time_;
+    if (deadline > budget) {
+        return false;
+    }
+    
+    // Yolda olabilecek slice'lar istenmez. En yüksek gelen slice'ın altındaki boşluk, beklenen
+    // varışı (frame başı + sıra x slice aralığı) sıra dışılık payını aştıysa; kuyruk (en yüksek
+    // slice'ın ötesi) ise beklenen frame sonu geçtiyse ve frame son varıştan bu yana pay kadar
+    // sessiz kaldıysa kayıp sayılır.
+    std::chrono::microseconds allowance;
+    if (measure_path_skew(frame, allowance)) {
+        allowance += 2 * std::chrono::microseconds(static_cast<int64_t>(slice_interval_us_));
+    } else {
+        allowance = min_wait_time_;
+    }
+    const auto tail_due_at = std::max(frame.last_slice_time,
+                                      frame.first_slice_time + expected_frame_span(frame)) + allowance;
+    const bool tail_due = tail_due_at <= now;
+    const double interval_us = slice_interval_us_;
+    uint16_t requested = 0;
+    auto is_due = [&](uint16_t slice_id) {
+        if (slice_id > frame.highest_slice_id || !frame.received_slices) return tail_due;
+        const auto expected = frame.first_slice_time + allowance +
+                              std::chrono::microseconds(static_cast<int64_t>(interval_us * slice_id));
+        return expected <= now;
+    };
+    const size_t length = build_nack(nack_packet_.data(), frame.frame_id, tunnel_id, [&](auto&& fn) {
+        frame.for_each_missing_slice([&](uint16_t slice_id) {
+            if (is_due(slice_id)) {
+                requested++;
+                fn(slice_id);
+            }
+        });
+    });
+    if (length == 0) {
+        // Eksikler hâlâ yolda: NACK turu harcamadan kuyruğun sessizleşeceği ana kadar bekle
+        const auto recheck = std::min(std::max(tail_due_at, now + PROBE_WAIT_GUARD), budget);
+        if (recheck <= now) return false;
+        frame.deadline = recheck;
+        frame.deadline_armed = true;
+        deadlines_.push(FrameDeadline{frame.deadline, frame.frame_id});
+        return true;
+    }
+    
+    const auto& tunnel = tunnels_[tunnel_id];
+    auto socket = tunnel_to_socket_.find(tunnel_id);
+    if (socket == tunnel_to_socket_.end() ||
+        sendto(socket->second, nack_packet_.data(), length, MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&tunnel.peer), sizeof(tunnel.peer)) != static_cast<ssize_t>(length)) {
+        return false;
+    }
+    
+    metrics_.on_nack(requested);
+    LOG_DEBUG("📨 Frame %u için %u slice NACK (Tunnel %d)", frame.frame_id, (unsigned)requested, (int)tunnel_id);
+    
+    // Yeniden gönderilen slice'lar için bekle, sonraki deadline'da FEC tekrar denenir
+    if (frame.nack_rounds == 0) {
+        frame.pre_nack_slices = frame.received_slices + frame.received_parity;
+        frame.pre_nack_time = frame.last_slice_time;
     }
+    frame.nack_rounds++;
+    frame.fec_applied = false;
+    frame.deadline = deadline;
+    frame.deadline_armed = true;
+    deadlines_.push(FrameDeadline{frame.deadline, frame.frame_id});
+    return true;
 }
 
-void ReassemblyEngine::update_tunnel_stats(uint8_t tunnel_id, uint32_t sent, 
-                                         uint32_t received, uint32_t lost) {
+void ReassemblyEngine::update_tunnel_rtt(uint8_t tunnel_id, double rtt_ms) {
+    for (auto& shard : shards_) {
+        shard->update_tunnel_rtt(tunnel_id, rtt_ms);
+    }
+    
     auto it = tunnels_.find(tunnel_id);
     if (it != tunnels_.end()) {
-        it->second.sent_packets = sent;
-        it->second.received_packets = received;
-        it->second.lost_packets = lost;
+        it->second.update_rtt(rtt_ms);
     }
 }
 
@@ -367,24 +1336,42 @@ double ReassemblyEngine::get_min_rtt() const {
     return (min_rtt == std::numeric_limits<double>::max()) ? 0.0 : min_rtt;
 }
 
-void ReassemblyEngine::cleanup_old_frames() {
-    auto now = std::chrono::steady_clock::now();
-    auto max_age = std::chrono::seconds(5); // 5 saniye
-    
-    for (auto it = frames_.begin(); it != frames_.end();) {
-        if (now - it->second.last_slice_time > max_age) {
-            std::cout << "🗑️ Eski frame " << it->first << " temizlendi" << std::endl;
-            it = frames_.erase(it);
-        } else {
-            ++it;
-        }
-    }
-}
-
 void ReassemblyEngine::set_frame_complete_callback(std::function<void(uint32_t, const std::vector<uint8_t>&)> callback) {
     frame_complete_callback_ = callback;
 }
 
+void ReassemblyEngine::set_frame_handle_callback(std::function<void(FrameHandle&&)> callback) {
+    frame_handle_callback_ = callback;
+}
+
 void ReassemblyEngine::set_frame_discard_callback(std::function<void(uint32_t)> callback) {
     frame_discard_callback_ = callback;
 }
+
+ReassemblyMetricsSnapshot ReassemblyEngine::get_metrics_snapshot() {
+    MetricsTotals totals;
+    metrics_.collect(totals);
+    totals.worker_cpu_ns += worker_cpu_time_ns();
+    for (const auto& shard : shards_) {
+        shard->metrics_.collect(totals);
+        totals.worker_cpu_ns += shard->worker_cpu_time_ns();
+    }
+    return metrics_.finalize(totals);
+}
+
+std::vector<TunnelProbeStats> ReassemblyEngine::get_tunnel_probe_stats() const {
+    return prober_ ? prober_->stats() : std::vector<TunnelProbeStats>();
+}
+
+std::chrono::microseconds ReassemblyEngine::get_measured_wait_time() const {
+    return prober_ ? prober_->wait_time() : std::chrono::microseconds(0);
+}
+
+const char* ReassemblyEngine::receive_backend_name() const {
+    if (!shards_.empty()) return shards_.front()->receive_backend_name();
+    return receiver_ ? receiver_->name() : "none";
+}
+
+void ReassemblyEngine::set_frame_timing_callback(std::function<void(uint32_t, const FrameTiming&)> callback) {
+    frame_timing_callback_ = callback;
+}
@@ -2,15 +2,61 @@
 #pragma once
 
 #include <map>
+#include <array>
 #include <vector>
 #include <queue>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <functional>
 #include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <thread>
+#include "frame_buffer_pool.h"
+#include "frame_handle.h"
+#include "fec_codec.h"
+#include "frame_delivery.h"
+#include "reassembly_metrics.h"
+#include "tunnel_probe.h"
+#include "slice_nack.h"
+#include "receive_backend.h"
+#include <atomic>
+
+// Frame penceresi sabitleri
+constexpr size_t FRAME_WINDOW_SIZE = 256;        // Aynı anda takip edilen frame sayısı (2'nin kuvveti)
+constexpr uint16_t MAX_SLICES_PER_FRAME = 1024;  // Frame başına kabul edilen maksimum slice
+constexpr size_t SLICE_BITMAP_WORDS = MAX_SLICES_PER_FRAME / 64;
+
+static_assert((FRAME_WINDOW_SIZE & (FRAME_WINDOW_SIZE - 1)) == 0, "FRAME_WINDOW_SIZE 2'nin kuvveti olmalı");
+
+// Frame başına en fazla FEC bloğu (blok başına en az FEC_MAX_SHARDS - FEC_MAX_PARITY_PER_BLOCK veri slice'ı)
+constexpr size_t FEC_MAX_BLOCKS_PER_FRAME =
+    (MAX_SLICES_PER_FRAME + FEC_MAX_SHARDS - FEC_MAX_PARITY_PER_BLOCK - 1) / (FEC_MAX_SHARDS - FEC_MAX_PARITY_PER_BLOCK);
+
+// Slice header formatı (12 byte, network byte order)
+struct SliceHeader {
+    uint32_t frame_id;      // 4 byte
+    uint16_t slice_id;      // 2 byte (parity slice'larda parity indeksi)
+    uint16_t total_slices;  // 2 byte (veri slice sayısı)
+    uint8_t tunnel_id;      // 1 byte
+    uint8_t reserved;       // 1 byte (FEC bilgisi, aşağıdaki bayraklara bakın)
+    uint8_t frame_flags;    // 1 byte (frame türü, FRAME_FLAG_*)
+    uint8_t reference_distance; // 1 byte (referans frame = frame_id - reference_distance)
+} __attribute__((packed));
+
+// SliceHeader::reserved: bit 7 = parity slice, bit 0-5 = blok başına parity sayısı (m)
+constexpr uint8_t SLICE_FLAG_PARITY = 0x80;
+constexpr uint8_t SLICE_FEC_PARITY_MASK = 0x3F;
+
+// SliceHeader::frame_flags (0 = tür bilgisi yok, keyframe boyuttan tahmin edilir)
+constexpr uint8_t FRAME_FLAG_KEYFRAME = 0x01;   // Bağımsız çözülebilen frame (IDR)
+constexpr uint8_t FRAME_FLAG_REFERENCE = 0x02;  // Sonraki frame'ler bu frame'i referans alır
+constexpr uint8_t FRAME_FLAG_DEPENDENT = 0x04;  // reference_distance gerideki frame olmadan çözülemez
 
 // Slice bilgisi
 struct SliceInfo {
@@ -18,58 +64,222 @@ struct SliceInfo {
     uint16_t slice_id;      // Slice ID (0-255)
     uint16_t total_slices;  // Toplam slice sayısı
     uint8_t tunnel_id;      // Hangi tünelden geldi
-    std::vector<uint8_t> data; // Slice verisi
+    const uint8_t* data;    // Slice verisi (alım slab'ındaki girdiye işaret eder, sahiplenmez)
+    size_t data_size;       // Slice verisi boyutu
     std::chrono::steady_clock::time_point arrival_time;
+    bool is_parity = false;  // FEC parity slice'ı mı
+    uint8_t fec_parity = 0;  // Frame'in blok başına parity sayısı (0 = FEC yok)
+    uint8_t frame_flags = 0; // FRAME_FLAG_* (0 = tür bilinmiyor)
+    uint32_t reference_id = 0; // Bağımlı frame'in referansı (FRAME_FLAG_DEPENDENT)
 };
 
 // Tünel profili
 struct TunnelProfile {
     uint8_t tunnel_id;
-    uint32_t sent_packets;
-    uint32_t received_packets;
-    uint32_t lost_packets;
     double avg_rtt_ms;
     std::chrono::steady_clock::time_point last_update;
+    double rtt_var_ms = 0.0;   // RTT'nin ortalamadan sapması (jitter)
+    sockaddr_in peer{};        // Son datagramın kaynağı (NACK hedefi)
+    bool has_peer = false;
     
     // RTT hesaplama
     void update_rtt(double rtt_ms) {
         if (avg_rtt_ms == 0.0) {
             avg_rtt_ms = rtt_ms;
+            rtt_var_ms = rtt_ms / 2;
         } else {
+            rtt_var_ms = rtt_var_ms * 0.75 + std::abs(avg_rtt_ms - rtt_ms) * 0.25;
             avg_rtt_ms = avg_rtt_ms * 0.9 + rtt_ms * 0.1; // Exponential moving average
         }
         last_update = std::chrono::steady_clock::now();
     }
+};
+
+// Bellek bütçesi aşıldığında atılma önceliği (küçük olan önce atılır)
+enum class FramePriority : uint8_t {
+    NON_REFERENCE = 0,  // Başka frame'in referans almadığı frame
+    REFERENCE = 1,      // Referans frame (tür bilinmiyorsa varsayılan)
+    KEYFRAME = 2        // Bağımsız çözülebilen frame (IDR)
+};
+
+// Boyutu ortalama frame'in bu katını aşan frame keyframe sayılır (tür bilgisi yoksa)
+constexpr double KEYFRAME_SIZE_RATIO = 4.0;
+// Keyframe'lerin eksik slice bekleme süresi çarpanı (max_wait_time ile sınırlı)
+constexpr int KEYFRAME_WAIT_FACTOR = 2;
+
+// Kaybedilen (atılan) referans frame'leri. Slot = frame_id % FRAME_WINDOW_SIZE, değer =
+// frame_id + 1 (0 = boş). Shard modunda tüm shard'lar aynı tabloyu paylaşır; referansı
+// başka shard'da kaybolan frame de atılabilir.
+struct LostFrameTable {
+    std::array<std::atomic<uint32_t>, FRAME_WINDOW_SIZE> slots{};
     
-    // Loss rate hesaplama
-    double get_loss_rate() const {
-        if (sent_packets == 0) return 0.0;
-        return static_cast<double>(lost_packets) / sent_packets;
+    void mark(uint32_t frame_id) {
+        slots[frame_id & (FRAME_WINDOW_SIZE - 1)].store(frame_id + 1, std::memory_order_relaxed);
+    }
+    bool contains(uint32_t frame_id) const {
+        return slots[frame_id & (FRAME_WINDOW_SIZE - 1)].load(std::memory_order_relaxed) == frame_id + 1;
     }
 };
 
-// Frame durumu
+// Frame durumu - pencere slotu olarak yeniden kullanılır
+// Son slice hariç tüm slice'lar aynı boyuttadır (slice_stride); her slice geldiği anda
+// havuzdan alınan birleşik buffer'da slice_id * slice_stride konumuna kopyalanır.
 struct FrameState {
     uint32_t frame_id;
-    std::map<uint16_t, SliceInfo> slices; // slice_id -> SliceInfo
+    std::vector<uint8_t> buffer;        // Havuzdan alınan birleşik frame buffer'ı
+    std::vector<uint8_t> pending_tail;  // Stride bilinmeden gelen son slice (geçici, kapasite korunur)
+    uint32_t slice_stride;              // Son slice hariç slice boyutu (0 = henüz bilinmiyor)
+    uint32_t last_slice_size;           // Son slice boyutu
+    std::array<uint64_t, SLICE_BITMAP_WORDS> received_mask; // Alınan slice bitmap'i
+    std::array<uint64_t, FEC_MAX_PARITY_SLICES / 64> parity_mask; // Alınan parity bitmap'i
     uint16_t total_slices;
     uint16_t received_slices;
+    uint16_t highest_slice_id;       // Şimdiye kadar gelen en büyük veri slice'ı (sıra dışılık ölçümü)
+    uint16_t parity_slices;       // Frame'in toplam parity slice sayısı
+    uint16_t received_parity;
+    uint8_t fec_parity_per_block; // Blok başına parity (0 = FEC yok)
+    uint16_t fec_blocks;          // FEC blok sayısı
+    uint16_t fec_short_blocks;    // Eksik veri slice'ı alınan parity'den fazla olan blok sayısı
+    std::array<int16_t, FEC_MAX_BLOCKS_PER_FRAME> fec_block_deficit; // Blok başına eksik - parity
+    bool fec_failed;              // Çözüm başarısız oldu, slice yolunda tekrar denenmez
+    uint8_t nack_rounds;          // Gönderilen NACK sayısı
+    uint16_t pre_nack_slices;     // İlk NACK'e kadar gelen slice sayısı (gönderim süresi ölçümü)
+    uint8_t frame_flags;          // FRAME_FLAG_* (ilk slice'tan)
+    uint32_t reference_id;        // FRAME_FLAG_DEPENDENT ise referans frame
+    FramePriority priority;       // Bellek bütçesi aşımında atılma sırası
+    size_t memory_bytes;          // Bütçeye yazılan frame buffer'ı boyutu
     std::chrono::steady_clock::time_point first_slice_time;
     std::chrono::steady_clock::time_point last_slice_time;
+    std::chrono::steady_clock::time_point pre_nack_time;   // İlk NACK'ten önceki son varış
+    std::chrono::steady_clock::time_point deadline; // Eksik slice bekleme sonu
+    std::chrono::steady_clock::time_point expire_at; // Bu andan sonra frame her durumda atılır
+    bool deadline_armed;
     bool fec_applied;
     bool discarded;
+    bool completed;
+    bool in_use;             // Slot şu an bir frame'i tutuyor mu
+    
+    FrameState()
+        : frame_id(0), slice_stride(0), last_slice_size(0), received_mask{}, parity_mask{},
+          total_slices(0), received_slices(0), parity_slices(0), received_parity(0), fec_parity_per_block(0),
+          fec_blocks(0), fec_short_blocks(0), fec_block_deficit{}, fec_failed(false), nack_rounds(0), pre_nack_slices(0), frame_flags(0), reference_id(0), priority(FramePriority::REFERENCE), memory_bytes(0), deadline_armed(false), fec_applied(false), discarded(false), completed(false), in_use(false) {}
+    
+    // Slotu yeni bir frame için hazırla (slice buffer'ları serbest bırakılmaz)
+    void reset(uint32_t id, uint16_t total, uint8_t fec_parity, std::chrono::steady_clock::time_point now) {
+        frame_id = id;
+        total_slices = total;
+        received_slices = 0;
+        highest_slice_id = 0;
+        fec_parity_per_block = fec_parity;
+        parity_slices = FecCodec::parity_slice_count(total, fec_parity);
+        received_parity = 0;
+        fec_blocks = FecCodec::block_count(total, fec_parity);
+        if (fec_blocks > FEC_MAX_BLOCKS_PER_FRAME) fec_blocks = 0;
+        fec_short_blocks = fec_blocks;
+        // Blok b'nin veri slice'ları b, b + blocks, ... (bkz. FecCodec)
+        for (uint16_t b = 0; b < fec_blocks; ++b) {
+            fec_block_deficit[b] = static_cast<int16_t>((total - b + fec_blocks - 1) / fec_blocks);
+        }
+        fec_failed = false;
+        nack_rounds = 0;
+        frame_flags = 0;
+        reference_id = 0;
+        priority = FramePriority::REFERENCE;
+        first_slice_time = now;
+        last_slice_time = now;
+        deadline_armed = false;
+        fec_applied = false;
+        discarded = false;
+        completed = false;
+        in_use = true;
+        slice_stride = 0;
+        last_slice_size = 0;
+        pending_tail.clear();
+        received_mask.fill(0);
+        parity_mask.fill(0);
+    }
+    
+    bool depends_on_reference() const {
+        return (frame_flags & FRAME_FLAG_DEPENDENT) != 0;
+    }
+    
+    // Tamamlanan frame'in toplam boyutu
+    size_t frame_size() const {
+        return static_cast<size_t>(total_slices - 1) * slice_stride + last_slice_size;
+    }
+    
+    bool has_slice(uint16_t slice_id) const {
+        return (received_mask[slice_id >> 6] >> (slice_id & 63)) & 1;
+    }
+    
+    // Slice'ı alındı olarak işaretle, daha önce alınmışsa false döner
+    bool mark_slice(uint16_t slice_id) {
+        uint64_t bit = uint64_t(1) << (slice_id & 63);
+        uint64_t& word = received_mask[slice_id >> 6];
+        if (word & bit) return false;
+        word |= bit;
+        received_slices++;
+        if (fec_blocks > 0) reduce_fec_deficit(slice_id % fec_blocks);
+        return true;
+    }
+    
+    bool has_parity(uint16_t parity_id) const {
+        return (parity_mask[parity_id >> 6] >> (parity_id & 63)) & 1;
+    }
+    
+    void mark_parity(uint16_t parity_id) {
+        parity_mask[parity_id >> 6] |= uint64_t(1) << (parity_id & 63);
+        received_parity++;
+        if (fec_blocks > 0 && parity_id / fec_parity_per_block < fec_blocks) {
+            reduce_fec_deficit(parity_id / fec_parity_per_block);
+        }
+    }
+    
+    // Her blokta kayıp kadar parity var mı (FEC ile kurtarılabilir)
+    bool fec_recoverable() const {
+        return fec_blocks > 0 && fec_short_blocks == 0;
+    }
+    
+    void reduce_fec_deficit(uint16_t block) {
+        if (fec_block_deficit[block]-- == 1) {
+            fec_short_blocks--;
+        }
+    }
+    
+    // Eksik slice'ları sırayla gez (bitmap üzerinde ctz taraması, allocation yok)
+    template <typename Fn>
+    void for_each_missing_slice(Fn&& fn) const {
+        const size_t words = (total_slices + 63) / 64;
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t gaps = ~received_mask[w];
+            // Son kelimede total_slices ötesindeki bitleri maskele
+            if (w == words - 1 && (total_slices & 63) != 0) {
+                gaps &= (uint64_t(1) << (total_slices & 63)) - 1;
+            }
+            while (gaps) {
+                fn(static_cast<uint16_t>(w * 64 + __builtin_ctzll(gaps)));
+                gaps &= gaps - 1;
+            }
+        }
+    }
     
     // Eksik slice'ları bul
     std::vector<uint16_t> get_missing_slices() const {
         std::vector<uint16_t> missing;
-        for (uint16_t i = 0; i < total_slices; ++i) {
-            if (slices.find(i) == slices.end()) {
-                missing.push_back(i);
-            }
-        }
+        missing.reserve(get_missing_count());
+        for_each_missing_slice([&missing](uint16_t slice_id) { missing.push_back(slice_id); });
         return missing;
     }
     
+    // Bitmap'teki alınmış slice sayısı (popcount)
+    uint16_t count_received_slices() const {
+        uint32_t count = 0;
+        for (uint64_t word : received_mask) {
+            count += __builtin_popcountll(word);
+        }
+        return static_cast<uint16_t>(count);
+    }
+    
     // Tamamlanma durumu
     bool is_complete() const {
         return received_slices >= total_slices;
@@ -87,6 +297,58 @@ public:
     ReassemblyEngine();
     ~ReassemblyEngine();
     
+    // Çok çekirdekli mod: initialize()'dan önce çağrılmalı. count > 1 ise her tünel portu
+    // count adet SO_REUSEPORT soketiyle açılır, datagramlar frame_id % count ile shard'lara
+    // dağıtılır ve tamamlanan frame'ler tek bir teslim aşamasında sıraya konur.
+    void set_worker_count(size_t count, bool pin_to_cores = true);
+    void set_cpu_affinity(int cpu); // Worker thread'ini bir çekirdeğe sabitle (-1 = kapalı)
+    
+    // Sıralı teslim: initialize()'dan önce çağrılmalı. delay > 0 ise frame'ler frame_id sırasıyla
+    // ayrı bir teslim thread'inden verilir; önceki eksik frame ilk slice + delay anına kadar
+    // gelmezse atlanır ve discard callback'i ile bildirilir. max_wait_time'dan küçük olmamalı.
+    // Shard modunda teslim her zaman sıralıdır (varsayılan delay = 2 * max_wait_time).
+    void set_playout_delay(std::chrono::milliseconds delay);
+    // Eksik slice bekleme süresinin sınırları (adaptif süre bu aralığa kırpılır)
+    void set_wait_time_limits(std::chrono::milliseconds min_wait, std::chrono::milliseconds max_wait);
+    // Tünel probe'ları: initialize()'dan önce çağrılmalı. Her tünelin karşı ucuna (ilk veri
+    // paketinin kaynağı) interval aralıkla probe gönderilir; echo'lardan RTT, jitter ve tüneller
+    // arası tek yön gecikme farkı ölçülür. Bekleme süresi farkın skew_percentile yüzdeliği +
+    // frame'in gönderim süresidir (ölçülen slice aralığı x slice sayısı).
+    // Echo gelmezse update_tunnel_rtt() ile verilen RTT'ler kullanılır. 0 = kapalı.
+    void set_probe_interval(std::chrono::milliseconds interval, double skew_percentile = 0.99);
+    // Seçici yeniden gönderim: bekleme süresi dolan eksik frame için FEC yetmezse, kayıp
+    // sayılan slice'ların bitmap'i (NACK) en düşük RTT'li tünelden göndericiye yollanır ve
+    // deadline bu tünelin RTT'si kadar uzatılır. Hâlâ yolda olabilecek slice'lar (beklenen
+    // varışı sıra dışılık payını aşmamış boşluklar, beklenen sonu geçmemiş ya da
+    // sessizleşmemiş frame'in kuyruğu) istenmez.
+    // Yanıt ilk slice + max_wait_time'a yetişmeyecekse frame atılır. Frame başına en fazla
+    // max_rounds NACK.
+    void set_retransmission(bool enabled, uint8_t max_rounds = 2);
+    // Frame'in ilk slice'ından sonra en fazla ne kadar tutulacağı; süresi dolan frame deadline
+    // durumundan bağımsız atılır. 0 (varsayılan) = playout bütçesi (playout delay, yoksa
+    // 2 * max_wait_time). max_wait_time'dan küçük olamaz.
+    void set_max_frame_age(std::chrono::milliseconds age);
+    // Yeniden birleştirilen frame buffer'larının toplam bellek sınırı (byte, 0 = sınırsız).
+    // Aşılırsa önce en eski referans olmayan frame'ler, en son keyframe'ler atılır; yeni
+    // frame kuyruktaki her frame'den önemsizse kendisi atılır. Shard modunda shard'lar
+    // arasında eşit bölünür.
+    void set_memory_budget(size_t bytes);
+    // Alım backend'i: initialize()'dan önce çağrılmalı. AUTO (varsayılan) io_uring multishot
+    // recvmsg'i dener, kernel desteklemiyorsa epoll + recvmmsg'e düşer.
+    void set_receive_backend(ReceiveBackendType type);
+    // Düşük gecikmeli alım: initialize()'dan önce çağrılmalı. spin_budget > 0 ise worker
+    // epoll_wait'i bloklamadan çağırır ve son olaydan sonra spin_budget dolana kadar uyumaz.
+    // Tünel soketleri edge-triggered kaydedilir, SO_BUSY_POLL (socket_busy_poll) ve
+    // SO_PREFER_BUSY_POLL ile açılır. Worker'a ayrılmış bir çekirdek gerektirir; CPU
+    // maliyeti metrik snapshot'ında (worker_cpu_cores) görülür. 0 = kapalı.
+    void set_busy_poll(std::chrono::microseconds spin_budget,
+                       std::chrono::microseconds socket_busy_poll = std::chrono::microseconds(50));
+    // UDP_GRO: initialize()'dan önce çağrılmalı. Kernel aynı kaynaktan ardışık gelen eşit
+    // boyutlu slice'ları tek datagramda verir, engine segmentlere bölüp tek tek işler.
+    // Yalnızca epoll backend'inde desteklenir: AUTO backend'de epoll seçtirir, açıkça
+    // IO_URING istenmişse yok sayılır.
+    void set_udp_gro(bool enabled);
+    
     // Ana fonksiyonlar
     bool initialize(const std::vector<std::string>& tunnel_ips, 
                    const std::vector<int>& tunnel_ports);
@@ -97,52 +359,179 @@ public:
     void process_slice(const SliceInfo& slice);
     void handle_frame_completion(uint32_t frame_id);
     
+    // Süresi dolan frame'leri işle (worker timerfd ile çağırır, run() kullanılmıyorsa dışarıdan çağrılabilir)
+    void process_deadlines(std::chrono::steady_clock::time_point now);
+    
     // RTT ve tünel yönetimi
     void update_tunnel_rtt(uint8_t tunnel_id, double rtt_ms);
-    void update_tunnel_stats(uint8_t tunnel_id, uint32_t sent, uint32_t received, uint32_t lost);
     
     // Callback'ler
     void set_frame_complete_callback(std::function<void(uint32_t, const std::vector<uint8_t>&)> callback);
     void set_frame_discard_callback(std::function<void(uint32_t)> callback);
+    // Sıfır kopyalı teslim: ayarlanırsa frame_complete callback'i yerine çağrılır. Handle
+    // birleşik buffer'ın sahibidir; callback'ten sonra da tutulabilir (ör. GstBuffer'a sarılıp
+    // asenkron işlenir, bkz. frame_handle_gst.h) ve bırakıldığında buffer havuza döner.
+    void set_frame_handle_callback(std::function<void(FrameHandle&&)> callback);
+    // Sıralı teslimde her frame'den hemen önce zamanlama bilgisi (gecikme ölçümü için)
+    void set_frame_timing_callback(std::function<void(uint32_t, const FrameTiming&)> callback);
+    
+    // Telemetri: worker'ı durdurmadan okunur (shard'lar toplanır). Oranlar önceki çağrıya göredir.
+    ReassemblyMetricsSnapshot get_metrics_snapshot();
+    // Probe ölçümleri ve bunlardan türetilen bekleme süresi (0 = henüz yeterli ölçüm yok)
+    std::vector<TunnelProbeStats> get_tunnel_probe_stats() const;
+    std::chrono::microseconds get_measured_wait_time() const;
+    // Kullanılan alım backend'i ("epoll" / "io_uring", başlatılmadıysa "none")
+    const char* receive_backend_name() const;
     
 private:
     // Epoll ve socket yönetimi
     int epoll_fd_;
     std::map<int, uint8_t> socket_to_tunnel_; // socket_fd -> tunnel_id
     std::map<uint8_t, int> tunnel_to_socket_; // tunnel_id -> socket_fd
+    int timer_fd_;                            // Frame deadline'ları için timerfd
+    
+    // Datagram alımı (epoll + recvmmsg ya da io_uring)
+    ReceiveBackendType receive_backend_type_ = ReceiveBackendType::AUTO;
+    std::unique_ptr<ReceiveBackend> receiver_;
+    std::chrono::microseconds busy_poll_budget_{0};     // 0 = bloklayan bekleme
+    std::chrono::microseconds socket_busy_poll_{50};
+    bool udp_gro_ = false;
     
     // Frame ve tünel durumları
-    std::map<uint32_t, FrameState> frames_; // frame_id -> FrameState
+    std::vector<FrameState> frames_; // frame_id % FRAME_WINDOW_SIZE -> FrameState (sabit pencere)
+    std::shared_ptr<FrameBufferPool> frame_pool_; // Birleşik frame buffer havuzu (FrameHandle'lar paylaşır)
+    FecCodec fec_codec_;             // Reed-Solomon kurtarma
+    ReassemblyMetrics metrics_;      // Lock-free telemetri (shard modunda shard başına)
     std::map<uint8_t, TunnelProfile> tunnels_; // tunnel_id -> TunnelProfile
     
+    // Eksik slice bekleyen frame'lerin deadline'ları (min-heap, geçersiz kayıtlar tembel silinir)
+    struct FrameDeadline {
+        std::chrono::steady_clock::time_point deadline;
+        uint32_t frame_id;
+        bool operator>(const FrameDeadline& other) const { return deadline > other.deadline; }
+    };
+    std::priority_queue<FrameDeadline, std::vector<FrameDeadline>, std::greater<FrameDeadline>> deadlines_;
+    // Frame yaşı sınırları (frame başına bir kayıt, aynı timerfd ile işlenir)
+    std::priority_queue<FrameDeadline, std::vector<FrameDeadline>, std::greater<FrameDeadline>> expiries_;
+    std::chrono::steady_clock::time_point armed_deadline_; // timerfd'ye kurulu olan deadline
+    
     // Adaptif bekleme parametreleri
     std::chrono::milliseconds max_wait_time_{200}; // Maksimum bekleme süresi
     std::chrono::milliseconds min_wait_time_{10};  // Minimum bekleme süresi
+    std::chrono::milliseconds max_frame_age_{0};   // 0 = playout bütçesi
+    double slice_interval_us_ = 0.0;               // Frame içi ortalama slice varış aralığı (EWMA)
+    
+    // Frame bellek bütçesi
+    size_t memory_budget_ = 0;                     // 0 = sınırsız
+    size_t frame_memory_bytes_ = 0;                // Pencerede tutulan frame buffer'ları
+    double average_frame_slices_ = 0.0;            // Keyframe olmayan frame'lerin ortalama boyutu
+    
+    // Atılan referans frame'leri (shard modunda ana engine'in tablosu paylaşılır)
+    std::unique_ptr<LostFrameTable> lost_frame_table_;
+    LostFrameTable* lost_frames_;
     
     // Callback'ler
     std::function<void(uint32_t, const std::vector<uint8_t>&)> frame_complete_callback_;
     std::function<void(uint32_t)> frame_discard_callback_;
+    std::function<void(FrameHandle&&)> frame_handle_callback_;
+    std::function<void(uint32_t, const FrameTiming&)> frame_timing_callback_;
     
     // Çalışma durumu
-    bool running_;
+    std::atomic<bool> running_;
     std::thread worker_thread_;
+    int cpu_affinity_;
+    
+    // Shard modu (worker_count_ > 1 ise bu nesne yalnızca shard'ları ve teslim aşamasını yönetir)
+    size_t worker_count_;
+    bool pin_to_cores_;
+    std::vector<std::unique_ptr<ReassemblyEngine>> shards_;
+    std::unique_ptr<FrameDeliveryStage> delivery_stage_;
+    std::chrono::milliseconds playout_delay_{0};
+    
+    // Tünel probe'ları (shard modunda shard 0 gönderir ve echo'ları alır, hepsi okur)
+    std::chrono::milliseconds probe_interval_{100};
+    double skew_percentile_ = 0.99;
+    std::unique_ptr<TunnelProber> tunnel_prober_;
+    TunnelProber* prober_;
+    bool probing_;                      // Bu engine probe gönderiyor mu
+    int probe_timer_fd_;
+    
+    // NACK ile yeniden gönderim
+    bool retransmission_enabled_ = true;
+    uint8_t max_nack_rounds_ = 2;
+    std::array<uint8_t, NACK_MAX_PACKET_SIZE> nack_packet_;
+    
+    // Shard olarak çalışırken
+    bool reuse_port_;                   // Soketler SO_REUSEPORT ile açılır
+    size_t shard_index_;
+    FrameDeliveryStage* delivery_;      // Sonuçların iletildiği teslim aşaması (yoksa callback)
+    bool is_shard() const { return delivery_ && !delivery_stage_; }
     
     // Private fonksiyonlar
+    bool initialize_shards(const std::vector<std::string>& tunnel_ips,
+                           const std::vector<int>& tunnel_ports);
+    void create_delivery_stage(size_t producer_count, std::chrono::milliseconds playout_delay);
+    bool start_probing();
+    void handle_probe_packet(const uint8_t* buffer, size_t length, uint8_t tunnel_id,
+                             std::chrono::steady_clock::time_point arrival_time);
+    void submit_result(FrameState& frame, std::vector<uint8_t>&& data);
     void worker_loop();
-    void handle_socket_event(int socket_fd);
-    void process_incoming_data(int socket_fd);
+    bool fall_back_to_epoll();
+    ReceiveOptions receive_options() const;
+    void enable_socket_busy_poll(int socket_fd);
+    int wait_for_events(struct epoll_event* events, int max_events,
+                        std::chrono::steady_clock::time_point& last_event);
+    uint64_t worker_cpu_time_ns();
+    void handle_datagrams(const ReceivedDatagram* datagrams, size_t count,
+                          std::chrono::steady_clock::time_point arrival_time);
+    void process_datagram(const uint8_t* buffer, size_t length, uint8_t tunnel_id,
+                          std::chrono::steady_clock::time_point arrival_time);
     
     // Adaptif bekleme
+    bool measure_path_skew(const FrameState& frame, std::chrono::microseconds& skew);
     std::chrono::milliseconds calculate_adaptive_wait_time(const FrameState& frame);
-    void wait_for_missing_slices(FrameState& frame);
+    void observe_frame_span(const FrameState& frame);
+    std::chrono::microseconds expected_frame_span(const FrameState& frame) const;
+    void schedule_frame_deadline(FrameState& frame);
+    void handle_frame_deadline(FrameState& frame, std::chrono::steady_clock::time_point now);
+    bool is_deadline_live(const FrameDeadline& entry);
+    bool is_expiry_live(const FrameDeadline& entry);
+    std::chrono::milliseconds frame_expiry_age() const;
+    void schedule_frame_expiry(FrameState& frame);
+    void expire_frames(std::chrono::steady_clock::time_point now);
+    void arm_deadline_timer();
     
     // FEC işlemleri
     bool apply_fec_recovery(FrameState& frame);
-    std::vector<uint8_t> reconstruct_frame(const FrameState& frame);
+    
+    // NACK ile yeniden gönderim
+    bool select_nack_tunnel(uint8_t& tunnel_id, std::chrono::microseconds& timeout);
+    bool request_retransmission(FrameState& frame, std::chrono::steady_clock::time_point now);
+    
+    // Slice'ın frame buffer'ına doğrudan yerleştirilmesi
+    bool ensure_frame_buffer(FrameState& frame, uint32_t stride);
+    bool place_slice(FrameState& frame, const SliceInfo& slice);
+    bool place_parity_slice(FrameState& frame, const SliceInfo& slice);
+    
+    // Frame penceresi
+    FrameState& frame_slot(uint32_t frame_id) { return frames_[frame_id & (FRAME_WINDOW_SIZE - 1)]; }
+    FrameState* acquire_frame(const SliceInfo& slice);
+    void release_frame(FrameState& frame);
+    void discard_frame(FrameState& frame);
+    FramePriority classify_frame(const SliceInfo& slice);
+    
+    // Frame bağımlılıkları
+    bool is_undecodable(const FrameState& frame) const;
+    void drop_undecodable(FrameState& frame);
+    void drop_dependents(uint32_t reference_id);
+    
+    // Bellek bütçesi
+    bool reserve_frame_memory(FrameState& frame, size_t bytes);
+    FrameState* select_eviction_victim(const FrameState& incoming);
+    void evict_frame(FrameState& frame);
     
     // Yardımcı fonksiyonlar
     double get_max_rtt() const;
     double get_min_rtt() const;
-    void cleanup_old_frames();
     void log_frame_stats(uint32_t frame_id, const FrameState& frame);
 };
@@ -0,0 +1,121 @@
+// reassembly_metrics.cpp - NovaEngine reassembly telemetrisi implementation
+#include "reassembly_metrics.h"
+#include <algorithm>
+
+static uint64_t to_microseconds(std::chrono::steady_clock::duration duration) {
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+}
+
+void ReassemblyMetrics::on_out_of_order(uint8_t tunnel_id, uint32_t depth) {
+    auto& tunnel = tunnels_[tunnel_id];
+    tunnel.out_of_order_slices.fetch_add(1, std::memory_order_relaxed);
+    uint32_t current = tunnel.max_reorder_depth.load(std::memory_order_relaxed);
+    while (depth > current &&
+           !tunnel.max_reorder_depth.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+    out_of_order_slices_.fetch_add(1, std::memory_order_relaxed);
+    reorder_depth_.record(depth);
+}
+
+void ReassemblyMetrics::on_frame_complete(std::chrono::steady_clock::duration assembly_time) {
+    frames_completed_.fetch_add(1, std::memory_order_relaxed);
+    assembly_latency_.record(to_microseconds(assembly_time));
+}
+
+void ReassemblyMetrics::on_frame_delivered(std::chrono::steady_clock::duration since_first_slice) {
+    frames_delivered_.fetch_add(1, std::memory_order_relaxed);
+    delivery_latency_.record(to_microseconds(since_first_slice));
+}
+
+void ReassemblyMetrics::collect(MetricsTotals& totals) const {
+    totals.slices_received += slices_received_.load(std::memory_order_relaxed);
+    totals.parity_slices += parity_slices_.load(std::memory_order_relaxed);
+    totals.duplicate_slices += duplicate_slices_.load(std::memory_order_relaxed);
+    totals.late_slices += late_slices_.load(std::memory_order_relaxed);
+    totals.invalid_slices += invalid_slices_.load(std::memory_order_relaxed);
+    totals.out_of_order_slices += out_of_order_slices_.load(std::memory_order_relaxed);
+    totals.frames_completed += frames_completed_.load(std::memory_order_relaxed);
+    totals.frames_recovered += frames_recovered_.load(std::memory_order_relaxed);
+    totals.slices_recovered += slices_recovered_.load(std::memory_order_relaxed);
+    totals.frames_discarded += frames_discarded_.load(std::memory_order_relaxed);
+    totals.frames_delivered += frames_delivered_.load(std::memory_order_relaxed);
+    totals.nacks_sent += nacks_sent_.load(std::memory_order_relaxed);
+    totals.slices_nacked += slices_nacked_.load(std::memory_order_relaxed);
+    totals.frames_retransmit_recovered += frames_retransmit_recovered_.load(std::memory_order_relaxed);
+    totals.frames_evicted += frames_evicted_.load(std::memory_order_relaxed);
+    totals.frames_undecodable += frames_undecodable_.load(std::memory_order_relaxed);
+    totals.frame_memory_bytes += frame_memory_bytes_.load(std::memory_order_relaxed);
+    totals.coalesced_datagrams += coalesced_datagrams_.load(std::memory_order_relaxed);
+    totals.coalesced_slices += coalesced_slices_.load(std::memory_order_relaxed);
+    totals.busy_polls += busy_polls_.load(std::memory_order_relaxed);
+    totals.empty_busy_polls += empty_busy_polls_.load(std::memory_order_relaxed);
+    totals.blocking_waits += blocking_waits_.load(std::memory_order_relaxed);
+    reorder_depth_.add_to(totals.reorder_depth);
+    assembly_latency_.add_to(totals.assembly_latency);
+    delivery_latency_.add_to(totals.delivery_latency);
+
+    for (size_t i = 0; i < METRICS_MAX_TUNNELS; ++i) {
+        const auto& tunnel = tunnels_[i];
+        auto& total = totals.tunnels[i];
+        total.tunnel_id = static_cast<uint8_t>(i);
+        total.slices += tunnel.slices.load(std::memory_order_relaxed);
+        total.bytes += tunnel.bytes.load(std::memory_order_relaxed);
+        total.duplicate_slices += tunnel.duplicate_slices.load(std::memory_order_relaxed);
+        total.out_of_order_slices += tunnel.out_of_order_slices.load(std::memory_order_relaxed);
+        total.max_reorder_depth = std::max(total.max_reorder_depth,
+                                           tunnel.max_reorder_depth.load(std::memory_order_relaxed));
+    }
+}
+
+ReassemblyMetricsSnapshot ReassemblyMetrics::finalize(const MetricsTotals& totals) {
+    ReassemblyMetricsSnapshot snapshot;
+    snapshot.taken_at = std::chrono::steady_clock::now();
+    snapshot.slices_received = totals.slices_received;
+    snapshot.parity_slices = totals.parity_slices;
+    snapshot.duplicate_slices = totals.duplicate_slices;
+    snapshot.late_slices = totals.late_slices;
+    snapshot.invalid_slices = totals.invalid_slices;
+    snapshot.out_of_order_slices = totals.out_of_order_slices;
+    snapshot.frames_completed = totals.frames_completed;
+    snapshot.frames_recovered = totals.frames_recovered;
+    snapshot.slices_recovered = totals.slices_recovered;
+    snapshot.frames_discarded = totals.frames_discarded;
+    snapshot.frames_delivered = totals.frames_delivered;
+    snapshot.nacks_sent = totals.nacks_sent;
+    snapshot.slices_nacked = totals.slices_nacked;
+    snapshot.frames_retransmit_recovered = totals.frames_retransmit_recovered;
+    snapshot.frames_evicted = totals.frames_evicted;
+    snapshot.frames_undecodable = totals.frames_undecodable;
+    snapshot.frame_memory_bytes = totals.frame_memory_bytes;
+    snapshot.coalesced_datagrams = totals.coalesced_datagrams;
+    snapshot.coalesced_slices = totals.coalesced_slices;
+    snapshot.busy_polls = totals.busy_polls;
+    snapshot.empty_busy_polls = totals.empty_busy_polls;
+    snapshot.blocking_waits = totals.blocking_waits;
+    snapshot.worker_cpu_seconds = totals.worker_cpu_ns / 1e9;
+    snapshot.reorder_depth = totals.reorder_depth.summarize();
+    snapshot.assembly_latency_us = totals.assembly_latency.summarize();
+    snapshot.delivery_latency_us = totals.delivery_latency.summarize();
+
+    std::lock_guard<std::mutex> lock(rate_mutex_);
+    const auto since = last_snapshot_ == std::chrono::steady_clock::time_point{} ? created_at_ : last_snapshot_;
+    snapshot.interval_seconds = std::chrono::duration<double>(snapshot.taken_at - since).count();
+    const double interval = snapshot.interval_seconds > 0.0 ? snapshot.interval_seconds : 1.0;
+    snapshot.slices_per_second = (totals.slices_received - last_slices_) / interval;
+    if (totals.worker_cpu_ns >= last_worker_cpu_ns_) {
+        snapshot.worker_cpu_cores = (totals.worker_cpu_ns - last_worker_cpu_ns_) / 1e9 / interval;
+    }
+
+    for (const auto& tunnel : totals.tunnels) {
+        if (tunnel.slices == 0) continue;
+        TunnelMetricsSnapshot entry = tunnel;
+        entry.slices_per_second = (tunnel.slices - last_tunnel_slices_[tunnel.tunnel_id]) / interval;
+        last_tunnel_slices_[tunnel.tunnel_id] = tunnel.slices;
+        snapshot.tunnels.push_back(entry);
+    }
+
+    last_snapshot_ = snapshot.taken_at;
+    last_slices_ = totals.slices_received;
+    last_worker_cpu_ns_ = totals.worker_cpu_ns;
+    return snapshot;
+}
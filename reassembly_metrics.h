@@ -0,0 +1,189 @@
+// reassembly_metrics.h - NovaEngine reassembly telemetrisi
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "hdr_histogram.h"
+
+constexpr size_t METRICS_MAX_TUNNELS = 256;   // tunnel_id uint8_t
+
+// Tünel başına sayaçlar (worker yazar, snapshot okur)
+struct TunnelCounters {
+    std::atomic<uint64_t> slices{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> duplicate_slices{0};
+    std::atomic<uint64_t> out_of_order_slices{0};
+    std::atomic<uint32_t> max_reorder_depth{0};
+};
+
+struct TunnelMetricsSnapshot {
+    uint8_t tunnel_id = 0;
+    uint64_t slices = 0;
+    uint64_t bytes = 0;
+    uint64_t duplicate_slices = 0;
+    uint64_t out_of_order_slices = 0;
+    uint32_t max_reorder_depth = 0;
+    double slices_per_second = 0.0;     // Önceki snapshot'tan bu yana
+};
+
+// get_metrics_snapshot() çıktısı; latency değerleri mikrosaniye
+struct ReassemblyMetricsSnapshot {
+    std::chrono::steady_clock::time_point taken_at;
+    double interval_seconds = 0.0;       // Önceki snapshot'tan bu yana geçen süre
+
+    uint64_t slices_received = 0;        // Veri + parity
+    uint64_t parity_slices = 0;
+    uint64_t duplicate_slices = 0;
+    uint64_t late_slices = 0;            // Teslim edilmiş/atılmış veya pencere dışı frame'e gelen
+    uint64_t invalid_slices = 0;
+    uint64_t out_of_order_slices = 0;
+    double slices_per_second = 0.0;
+
+    uint64_t frames_completed = 0;
+    uint64_t frames_recovered = 0;       // FEC ile tamamlanan
+    uint64_t slices_recovered = 0;
+    uint64_t frames_discarded = 0;
+    uint64_t frames_delivered = 0;
+    uint64_t nacks_sent = 0;             // Gönderilen NACK paketi
+    uint64_t slices_nacked = 0;          // NACK ile istenen slice
+    uint64_t frames_retransmit_recovered = 0; // NACK sonrası tamamlanan frame
+    uint64_t frames_evicted = 0;         // Bellek bütçesi için atılan (frames_discarded'a dahil)
+    uint64_t frames_undecodable = 0;     // Referansı kaybolduğu için atılan (frames_discarded'a dahil)
+    uint64_t frame_memory_bytes = 0;     // Şu an pencerede tutulan frame buffer'ları
+    uint64_t coalesced_datagrams = 0;    // UDP_GRO ile birleşik gelen datagram
+    uint64_t coalesced_slices = 0;       // Bunlardan ayrılan slice
+
+    // Worker bekleme maliyeti
+    uint64_t busy_polls = 0;             // Bloklamayan epoll_wait (busy-poll modu)
+    uint64_t empty_busy_polls = 0;       // Olay getirmeyen bloklamayan epoll_wait
+    uint64_t blocking_waits = 0;         // Spin bütçesi dolduktan sonra uyunan bekleme
+    double worker_cpu_seconds = 0.0;     // Worker thread'lerinin toplam CPU süresi
+    double worker_cpu_cores = 0.0;       // Önceki snapshot'tan bu yana ortalama (1.0 = tam çekirdek)
+
+    HistogramSnapshot reorder_depth;        // Slice, frame içinde kaç slice geriden geldi
+    HistogramSnapshot assembly_latency_us;  // İlk slice -> son slice (tamamlanan frame'ler)
+    HistogramSnapshot delivery_latency_us;  // İlk slice -> callback
+    std::vector<TunnelMetricsSnapshot> tunnels;
+};
+
+// Shard'lar arasında toplanabilen ham değerler
+struct MetricsTotals {
+    uint64_t slices_received = 0;
+    uint64_t parity_slices = 0;
+    uint64_t duplicate_slices = 0;
+    uint64_t late_slices = 0;
+    uint64_t invalid_slices = 0;
+    uint64_t out_of_order_slices = 0;
+    uint64_t frames_completed = 0;
+    uint64_t frames_recovered = 0;
+    uint64_t slices_recovered = 0;
+    uint64_t frames_discarded = 0;
+    uint64_t frames_delivered = 0;
+    uint64_t nacks_sent = 0;
+    uint64_t slices_nacked = 0;
+    uint64_t frames_retransmit_recovered = 0;
+    uint64_t frames_evicted = 0;
+    uint64_t frames_undecodable = 0;
+    uint64_t frame_memory_bytes = 0;
+    uint64_t coalesced_datagrams = 0;
+    uint64_t coalesced_slices = 0;
+    uint64_t busy_polls = 0;
+    uint64_t empty_busy_polls = 0;
+    uint64_t blocking_waits = 0;
+    uint64_t worker_cpu_ns = 0;          // Engine doldurur (thread CPU saati)
+    HistogramCounts reorder_depth;
+    HistogramCounts assembly_latency;
+    HistogramCounts delivery_latency;
+    std::array<TunnelMetricsSnapshot, METRICS_MAX_TUNNELS> tunnels{};
+};
+
+// Engine (veya shard) başına lock-free metrikler. Kayıt fonksiyonları relaxed atomik
+// artırmalardır; snapshot worker'ı durdurmadan alınır.
+class ReassemblyMetrics {
+public:
+    void on_slice(uint8_t tunnel_id, size_t bytes, bool is_parity) {
+        auto& tunnel = tunnels_[tunnel_id];
+        tunnel.slices.fetch_add(1, std::memory_order_relaxed);
+        tunnel.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        slices_received_.fetch_add(1, std::memory_order_relaxed);
+        if (is_parity) parity_slices_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void on_duplicate(uint8_t tunnel_id) {
+        tunnels_[tunnel_id].duplicate_slices.fetch_add(1, std::memory_order_relaxed);
+        duplicate_slices_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void on_out_of_order(uint8_t tunnel_id, uint32_t depth);
+    void on_late_slice() { late_slices_.fetch_add(1, std::memory_order_relaxed); }
+    void on_invalid_slice() { invalid_slices_.fetch_add(1, std::memory_order_relaxed); }
+    void on_frame_complete(std::chrono::steady_clock::duration assembly_time);
+    void on_frame_recovered(uint16_t slices) {
+        frames_recovered_.fetch_add(1, std::memory_order_relaxed);
+        slices_recovered_.fetch_add(slices, std::memory_order_relaxed);
+    }
+    void on_frame_discard() { frames_discarded_.fetch_add(1, std::memory_order_relaxed); }
+    void on_frame_delivered(std::chrono::steady_clock::duration since_first_slice);
+    void on_nack(uint16_t slices) {
+        nacks_sent_.fetch_add(1, std::memory_order_relaxed);
+        slices_nacked_.fetch_add(slices, std::memory_order_relaxed);
+    }
+    void on_frame_retransmit_recovered() { frames_retransmit_recovered_.fetch_add(1, std::memory_order_relaxed); }
+    void on_frame_evicted() { frames_evicted_.fetch_add(1, std::memory_order_relaxed); }
+    void on_frame_undecodable() { frames_undecodable_.fetch_add(1, std::memory_order_relaxed); }
+    void set_frame_memory(size_t bytes) { frame_memory_bytes_.store(bytes, std::memory_order_relaxed); }
+    void on_coalesced(size_t segments) {
+        coalesced_datagrams_.fetch_add(1, std::memory_order_relaxed);
+        coalesced_slices_.fetch_add(segments, std::memory_order_relaxed);
+    }
+    void on_busy_poll(bool empty) {
+        busy_polls_.fetch_add(1, std::memory_order_relaxed);
+        if (empty) empty_busy_polls_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void on_blocking_wait() { blocking_waits_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Ham değerleri totals'a ekle (shard'lar için birden çok kez çağrılabilir)
+    void collect(MetricsTotals& totals) const;
+
+    // Toplamlardan snapshot üret; oranlar bu nesnenin önceki finalize çağrısına göre hesaplanır
+    ReassemblyMetricsSnapshot finalize(const MetricsTotals& totals);
+
+private:
+    std::array<TunnelCounters, METRICS_MAX_TUNNELS> tunnels_;
+    std::atomic<uint64_t> slices_received_{0};
+    std::atomic<uint64_t> parity_slices_{0};
+    std::atomic<uint64_t> duplicate_slices_{0};
+    std::atomic<uint64_t> late_slices_{0};
+    std::atomic<uint64_t> invalid_slices_{0};
+    std::atomic<uint64_t> out_of_order_slices_{0};
+    std::atomic<uint64_t> frames_completed_{0};
+    std::atomic<uint64_t> frames_recovered_{0};
+    std::atomic<uint64_t> slices_recovered_{0};
+    std::atomic<uint64_t> frames_discarded_{0};
+    std::atomic<uint64_t> frames_delivered_{0};
+    std::atomic<uint64_t> nacks_sent_{0};
+    std::atomic<uint64_t> slices_nacked_{0};
+    std::atomic<uint64_t> frames_retransmit_recovered_{0};
+    std::atomic<uint64_t> frames_evicted_{0};
+    std::atomic<uint64_t> frames_undecodable_{0};
+    std::atomic<uint64_t> frame_memory_bytes_{0};
+    std::atomic<uint64_t> coalesced_datagrams_{0};
+    std::atomic<uint64_t> coalesced_slices_{0};
+    std::atomic<uint64_t> busy_polls_{0};
+    std::atomic<uint64_t> empty_busy_polls_{0};
+    std::atomic<uint64_t> blocking_waits_{0};
+    HdrHistogram reorder_depth_;
+    HdrHistogram assembly_latency_;
+    HdrHistogram delivery_latency_;
+
+    // Oran hesabı (yalnızca snapshot yolunda)
+    std::mutex rate_mutex_;
+    std::chrono::steady_clock::time_point created_at_ = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_snapshot_;
+    uint64_t last_slices_ = 0;
+    uint64_t last_worker_cpu_ns_ = 0;
+    std::array<uint64_t, METRICS_MAX_TUNNELS> last_tunnel_slices_{};
+};
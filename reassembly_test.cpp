@@ -1,15 +1,18 @@
 // reassembly_test.cpp - NovaEngine Reassembly Test Uygulaması
 #include "reassembly_engine.h"
+#include "async_logger.h"
+#include "traffic_generator.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <random>
+#include <atomic>
 
 class ReassemblyTest {
 private:
     ReassemblyEngine engine_;
     std::thread sender_thread_;
-    bool running_;
+    std::atomic<bool> running_;
     
 public:
     ReassemblyTest() : running_(false) {
@@ -31,21 +34,17 @@ public:
         std::vector<int> tunnel_ports = {5001, 5002};
         
         if (!engine_.initialize(tunnel_ips, tunnel_ports)) {
-            std::cerr << "HATA: Engine başlatılamadı!" << std::endl;
+            LOG_ERROR("HATA: Engine başlatılamadı!");
             return false;
         }
         
-        // RTT simülasyonu için tünel istatistiklerini ayarla
-        engine_.update_tunnel_rtt(0, 15.0); // Tunnel 0: 15ms RTT
-        engine_.update_tunnel_rtt(1, 45.0); // Tunnel 1: 45ms RTT (yavaş)
-        
         engine_.run();
         running_ = true;
         
         // Simülasyon thread'ini başlat
         sender_thread_ = std::thread(&ReassemblyTest::simulate_sender, this);
         
-        std::cout << "✓ Reassembly test başlatıldı" << std::endl;
+        LOG_INFO("✓ Reassembly test başlatıldı");
         return true;
     }
     
@@ -57,87 +56,106 @@ public:
             sender_thread_.join();
         }
         
-        std::cout << "✓ Reassembly test durduruldu" << std::endl;
+        LOG_INFO("✓ Reassembly test durduruldu");
+    }
+    
+    void print_metrics() {
+        auto metrics = engine_.get_metrics_snapshot();
+        LOG_INFO("📊 %.0f slice/s | tamamlanan %llu, FEC %llu, atılan %llu (çözülemez %llu) | duplicate %llu, sıra dışı %llu",
+                 metrics.slices_per_second,
+                 (unsigned long long)metrics.frames_completed, (unsigned long long)metrics.frames_recovered,
+                 (unsigned long long)metrics.frames_discarded, (unsigned long long)metrics.frames_undecodable,
+                 (unsigned long long)metrics.duplicate_slices,
+                 (unsigned long long)metrics.out_of_order_slices);
+        LOG_INFO("📊 NACK %llu (%llu slice), yeniden gönderimle kurtarılan frame %llu",
+                 (unsigned long long)metrics.nacks_sent, (unsigned long long)metrics.slices_nacked,
+                 (unsigned long long)metrics.frames_retransmit_recovered);
+        LOG_INFO("📊 Worker CPU %%%.1f çekirdek | spin %llu (boş %llu), uyku %llu",
+                 metrics.worker_cpu_cores * 100, (unsigned long long)metrics.busy_polls,
+                 (unsigned long long)metrics.empty_busy_polls, (unsigned long long)metrics.blocking_waits);
+        LOG_INFO("📊 Tamamlanma (ilk->son slice) p50/p99/p999: %llu/%llu/%llu µs | teslim p99: %llu µs",
+                 (unsigned long long)metrics.assembly_latency_us.p50,
+                 (unsigned long long)metrics.assembly_latency_us.p99,
+                 (unsigned long long)metrics.assembly_latency_us.p999,
+                 (unsigned long long)metrics.delivery_latency_us.p99);
+        for (const auto& probe : engine_.get_tunnel_probe_stats()) {
+            LOG_INFO("📡   Tunnel %d: RTT %.2fms (±%.2f, min %.2f), skew %.2fms | probe %llu, echo %llu",
+                     (int)probe.tunnel_id, probe.rtt_ms, probe.rtt_var_ms, probe.min_rtt_ms, probe.skew_ms,
+                     (unsigned long long)probe.probes_sent, (unsigned long long)probe.echoes_received);
+        }
+        LOG_INFO("📡 Ölçülen bekleme süresi: %lld µs",
+                 (long long)engine_.get_measured_wait_time().count());
+        for (const auto& tunnel : metrics.tunnels) {
+            LOG_INFO("📊   Tunnel %d: %.0f slice/s, duplicate %llu, sıra dışı %llu (max derinlik %u)",
+                     (int)tunnel.tunnel_id, tunnel.slices_per_second,
+                     (unsigned long long)tunnel.duplicate_slices,
+                     (unsigned long long)tunnel.out_of_order_slices, tunnel.max_reorder_depth);
+        }
     }
     
 private:
     void simulate_sender() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> delay_dist(10, 100); // 10-100ms arası gecikme
-        std::uniform_int_distribution<> loss_dist(1, 100); // %1-100 loss simülasyonu
+        // 4 x 1KB slice + 1 parity, %10 kayıp, tünel gecikmeleri RTT/2 (7.5ms ve 22.5ms) + 10ms jitter.
+        // Slice'lar varış zamanlarında gerçek UDP ile tünel portlarına gönderilir.
+        TrafficConfig config;
+        config.seed = std::random_device{}();
+        config.frame_size = 4 * 1024;
+        config.slice_size = 1024;
+        config.fec_parity = 1;
+        config.gop_size = 10;               // Her 10 frame'de bir keyframe (2 parity)
+        config.keyframe_fec_parity = 2;
+        config.frame_rate = 2.0;            // Frame'ler arası 500ms
+        config.pacing = 0.02;               // Slice'lar frame başında 10ms içinde gönderilir
+        config.loss = 0.10;
+        config.tunnel_delay_ms = {7.5, 22.5};
+        config.jitter_ms = 10.0;
+        
+        TrafficGenerator generator(config);
+        LoopbackSender sender("127.0.0.1", {5001, 5002});
+        if (!sender.is_open()) {
+            LOG_ERROR("HATA: Gönderici socket'i açılamadı!");
+            return;
+        }
+        // Engine'in probe ve NACK'leri aynı tünel gecikmeleriyle yanıtlanır (RTT 15ms ve 45ms)
+        sender.set_feedback_delays(config.tunnel_delay_ms, config.jitter_ms, config.seed);
         
+        const auto start = std::chrono::steady_clock::now();
         uint32_t frame_id = 0;
+        GeneratedSlice slice;
         
         while (running_) {
-            // Her frame için 4 slice oluştur
-            const int total_slices = 4;
-            std::vector<std::thread> slice_threads;
+            const uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
             
-            for (int slice_id = 0; slice_id < total_slices; ++slice_id) {
-                slice_threads.emplace_back([this, frame_id, slice_id, total_slices, &gen, &delay_dist, &loss_dist]() {
-                    // Rastgele gecikme
-                    std::this_thread::sleep_for(std::chrono::milliseconds(delay_dist(gen)));
-                    
-                    // Rastgele loss simülasyonu (%10 loss)
-                    if (loss_dist(gen) <= 10) {
-                        std::cout << "❌ Frame " << frame_id << " Slice " << slice_id << " kayboldu (simülasyon)" << std::endl;
-                        return;
-                    }
-                    
-                    // Slice verisi oluştur
-                    std::vector<uint8_t> slice_data(1024, slice_id); // 1KB test verisi
-                    
-                    // Rastgele tünel seç (0 veya 1)
-                    uint8_t tunnel_id = (gen() % 2);
-                    
-                    // Slice'ı gönder (simülasyon)
-                    simulate_slice_send(frame_id, slice_id, total_slices, tunnel_id, slice_data);
-                });
+            while (generator.frame_send_time(frame_id) <= now) {
+                // Tüm slice'lar önbelleğe alınır (simüle edilen kayıplar NACK ile istenebilir)
+                for (uint16_t index = 0; index < generator.slice_count(frame_id); ++index) {
+                    generator.slice(frame_id, index, slice);
+                    sender.cache(slice);
+                }
+                generator.generate_frame(frame_id++);
             }
-            
-            // Tüm slice thread'lerini bekle
-            for (auto& thread : slice_threads) {
-                thread.join();
+            while (generator.next_arrival(now, slice)) {
+                LOG_DEBUG("📤 Frame %u%s%u/%u (Tunnel %d)", slice.frame_id, slice.is_parity ? " Parity " : " Slice ",
+                          slice.slice_id, slice.total_slices, (int)slice.tunnel_id);
+                sender.queue(slice);
             }
+            sender.flush();
+            sender.poll_feedback();
             
-            frame_id++;
-            
-            // Frame'ler arası bekleme
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
     
-    void simulate_slice_send(uint32_t frame_id, uint16_t slice_id, uint16_t total_slices, 
-                           uint8_t tunnel_id, const std::vector<uint8_t>& data) {
-        // Gerçek UDP gönderimi yerine simülasyon
-        // Gerçek uygulamada burada UDP socket ile gönderim yapılır
-        
-        std::cout << "📤 Frame " << frame_id << " Slice " << (int)slice_id 
-                  << "/" << total_slices << " (Tunnel " << (int)tunnel_id << ")" << std::endl;
-        
-        // Slice'ı engine'e gönder
-        SliceInfo slice;
-        slice.frame_id = frame_id;
-        slice.slice_id = slice_id;
-        slice.total_slices = total_slices;
-        slice.tunnel_id = tunnel_id;
-        slice.data = data;
-        slice.arrival_time = std::chrono::steady_clock::now();
-        
-        engine_.process_slice(slice);
-    }
-    
     void on_frame_complete(uint32_t frame_id, const std::vector<uint8_t>& frame_data) {
-        std::cout << "🎯 FRAME TAMAMLANDI: " << frame_id 
-                  << " (" << frame_data.size() << " bytes)" << std::endl;
+        LOG_INFO("🎯 FRAME TAMAMLANDI: %u (%zu bytes)", frame_id, frame_data.size());
         
         // Gerçek uygulamada burada frame'i decode edip video sink'e gönderirsiniz
         // Örnek: GStreamer pipeline'a frame_data'yı gönder
     }
     
     void on_frame_discard(uint32_t frame_id) {
-        std::cout << "❌ FRAME ATILDI: " << frame_id << std::endl;
+        LOG_INFO("❌ FRAME ATILDI: %u", frame_id);
         
         // Gerçek uygulamada burada frame drop istatistiklerini günceller
         // ve gerekirse FEC parametrelerini ayarlarsınız
@@ -150,27 +168,29 @@ int main() {
     std::cout << "========================================================\n";
     std::cout << "Bu test, multi-path UDP slice reassembly sistemini simüle eder.\n";
     std::cout << "- 2 farklı RTT'li tünel (15ms ve 45ms)\n";
-    std::cout << "- %10 paket kaybı simülasyonu\n";
-    std::cout << "- Adaptif bekleme (RTT farkına göre)\n";
-    std::cout << "- FEC recovery (placeholder)\n";
+    std::cout << "- %10 paket kaybı, 10ms jitter (UDP loopback, seed'li trafik üreteci)\n";
+    std::cout << "- Adaptif bekleme (probe/echo ile ölçülen tek yön gecikme farkına göre)\n";
+    std::cout << "- FEC recovery (Reed-Solomon, frame başına 1 parity slice)\n";
+    std::cout << "- NACK ile seçici yeniden gönderim (en düşük RTT'li tünelden)\n";
     std::cout << "========================================================\n\n";
     
     ReassemblyTest test;
     
     if (!test.start()) {
-        std::cerr << "Test başlatılamadı!" << std::endl;
+        LOG_ERROR("Test başlatılamadı!");
         return 1;
     }
     
-    std::cout << "Test çalışıyor... Çıkmak için Ctrl+C basın.\n";
+    LOG_INFO("Test çalışıyor... Çıkmak için Ctrl+C basın.");
     
     // Ana thread'de bekle
     try {
         while (true) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            test.print_metrics();
         }
     } catch (const std::exception& e) {
-        std::cout << "\nTest durduruluyor..." << std::endl;
+        LOG_INFO("Test durduruluyor...");
     }
     
     test.stop();
@@ -0,0 +1,141 @@
+// receive_backend.cpp - NovaEngine alım backend'leri implementation
+#include "receive_backend.h"
+#include "io_uring_backend.h"
+#include "async_logger.h"
+#include <cstring>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <netinet/udp.h>
+
+// UDP_GRO cmsg'i için mesaj başına ayrılan alan (uint64_t cinsinden, cmsghdr hizalı)
+static constexpr size_t GRO_CONTROL_WORDS = (CMSG_SPACE(sizeof(int)) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+EpollReceiveBackend::EpollReceiveBackend(const ReceiveOptions& options)
+    : options_(options),
+      batch_size_(options.udp_gro ? GRO_BATCH_SIZE : RECV_BATCH_SIZE),
+      slot_size_(options.udp_gro ? GRO_SLOT_SIZE : RECV_SLOT_SIZE),
+      slab_(batch_size_ * slot_size_), iovecs_(batch_size_),
+      control_(options.udp_gro ? batch_size_ * GRO_CONTROL_WORDS : 0), msgs_(batch_size_),
+      addrs_(batch_size_), batch_(batch_size_) {
+    // recvmmsg mesajlarını slab girdilerine bağla
+    for (size_t i = 0; i < batch_size_; ++i) {
+        iovecs_[i].iov_base = slab_.data() + i * slot_size_;
+        iovecs_[i].iov_len = slot_size_;
+        memset(&msgs_[i], 0, sizeof(msgs_[i]));
+        msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+        msgs_[i].msg_hdr.msg_name = &addrs_[i];
+        msgs_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        if (options_.udp_gro) {
+            msgs_[i].msg_hdr.msg_control = &control_[i * GRO_CONTROL_WORDS];
+        }
+    }
+}
+
+bool EpollReceiveBackend::start(int epoll_fd, const std::map<int, uint8_t>& sockets) {
+    for (const auto& entry : sockets) {
+        if (options_.udp_gro) {
+            int enable = 1;
+            if (setsockopt(entry.first, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) < 0) {
+                LOG_WARN("UYARI: UDP_GRO açılamadı: %s", strerror(errno));
+            }
+        }
+
+        struct epoll_event ev;
+        ev.events = options_.edge_triggered ? (EPOLLIN | EPOLLET) : EPOLLIN;
+        ev.data.fd = entry.first;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, entry.first, &ev) < 0) {
+            LOG_ERROR("HATA: Epoll'e socket eklenemedi: %s", strerror(errno));
+            return false;
+        }
+    }
+    sockets_ = sockets;
+    return true;
+}
+
+// recvmsg'in döndürdüğü UDP_GRO segment boyutu (cmsg yoksa 0)
+static uint16_t gro_segment_size(struct msghdr& msg) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segment_size;
+            memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+            return static_cast<uint16_t>(segment_size);
+        }
+    }
+    return 0;
+}
+
+bool EpollReceiveBackend::on_readable(int fd) {
+    auto it = sockets_.find(fd);
+    if (it == sockets_.end()) return false;
+    const uint8_t tunnel_id = it->second;
+
+    while (true) {
+        // Kernel msg_controllen'i her çağrıda günceller
+        if (options_.udp_gro) {
+            for (size_t i = 0; i < batch_size_; ++i) {
+                msgs_[i].msg_hdr.msg_controllen = GRO_CONTROL_WORDS * sizeof(uint64_t);
+            }
+        }
+
+        // Tek syscall ile slab'ı doldur
+        int received = recvmmsg(fd, msgs_.data(), batch_size_, MSG_DONTWAIT, nullptr);
+
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("HATA: Recvmmsg başarısız: %s", strerror(errno));
+            }
+            break; // Non-blocking, veri yok
+        }
+
+        // Batch başına tek saat okuması
+        auto arrival_time = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < received; ++i) {
+            auto& datagram = batch_[i];
+            datagram.data = slab_.data() + i * slot_size_;
+            datagram.length = msgs_[i].msg_len;
+            datagram.source = &addrs_[i];
+            datagram.tunnel_id = tunnel_id;
+            datagram.truncated = (msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+            datagram.segment_size = options_.udp_gro ? gro_segment_size(msgs_[i].msg_hdr) : 0;
+        }
+        if (received > 0 && handler_) {
+            handler_(batch_.data(), received, arrival_time);
+        }
+
+        // Edge-triggered modda yeni olay gelmeyebilir, EAGAIN'e kadar devam et
+        if (!options_.edge_triggered && received < static_cast<int>(batch_size_)) {
+            break; // Soket boşaldı
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<ReceiveBackend> create_receive_backend(ReceiveBackendType type, int epoll_fd,
+                                                       const std::map<int, uint8_t>& sockets,
+                                                       ReceiveBackend::BatchHandler handler,
+                                                       const ReceiveOptions& options) {
+    // UDP_GRO yalnızca epoll'de desteklenir; AUTO bu durumda doğrudan epoll seçer
+    if (type == ReceiveBackendType::IO_URING ||
+        (type == ReceiveBackendType::AUTO && !options.udp_gro)) {
+        auto uring = std::make_unique<IoUringReceiveBackend>();
+        uring->set_handler(handler);
+        if (uring->start(epoll_fd, sockets)) {
+            if (options.udp_gro) {
+                LOG_WARN("UYARI: UDP_GRO yalnızca epoll backend'inde destekleniyor, io_uring ile kapalı");
+            }
+            return uring;
+        }
+        if (type == ReceiveBackendType::IO_URING) {
+            LOG_WARN("UYARI: io_uring kullanılamıyor, epoll'e geçiliyor");
+        }
+    }
+
+    auto epoll = std::make_unique<EpollReceiveBackend>(options);
+    epoll->set_handler(handler);
+    if (!epoll->start(epoll_fd, sockets)) {
+        return nullptr;
+    }
+    return epoll;
+}
@@ -0,0 +1,95 @@
+// receive_backend.h - NovaEngine tünel soketleri için alım backend'leri
+#pragma once
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+// Toplu alım sabitleri
+constexpr size_t RECV_BATCH_SIZE = 64;    // Handler çağrısı başına maksimum datagram
+constexpr size_t RECV_SLOT_SIZE = 2048;   // Datagram buffer'ı boyutu (MTU + pay)
+constexpr size_t GRO_BATCH_SIZE = 16;     // UDP_GRO açıkken recvmmsg başına birleşik datagram
+constexpr size_t GRO_SLOT_SIZE = 65536;   // Birleşik datagram en fazla 64 KB
+
+enum class ReceiveBackendType {
+    AUTO,       // io_uring varsa io_uring, yoksa epoll (UDP_GRO açıksa her zaman epoll)
+    EPOLL,      // epoll + recvmmsg
+    IO_URING    // Multishot recvmsg + provided buffer ring (yoksa epoll'e düşer)
+};
+
+// Alınan datagram; data backend'in buffer'ına işaret eder ve yalnızca handler süresince geçerlidir
+struct ReceivedDatagram {
+    const uint8_t* data;
+    size_t length;
+    const sockaddr_in* source;
+    uint8_t tunnel_id;
+    bool truncated;         // RECV_SLOT_SIZE'dan büyük datagram (veri eksik)
+    uint16_t segment_size;  // UDP_GRO ile birleştirilmiş datagramın segment boyutu (0 = tek datagram)
+};
+
+// Alım seçenekleri (backend'ler desteklemedikleri seçenekleri yok sayar)
+struct ReceiveOptions {
+    bool edge_triggered = false;    // Soketler EPOLLET ile kaydedilir (busy-poll modu)
+    bool udp_gro = false;           // Soketlerde UDP_GRO açılır, ardışık datagramlar birleşik gelir
+};
+
+// Tünel soketlerinden datagram alır ve toplu olarak handler'a verir. Backend engine'in
+// epoll'üne kendi fd'lerini ekler; worker bu fd'lerden biri okunabilir olduğunda
+// on_readable()'ı çağırır. Tek bir worker thread'inden kullanılır.
+class ReceiveBackend {
+public:
+    using BatchHandler = std::function<void(const ReceivedDatagram*, size_t, std::chrono::steady_clock::time_point)>;
+
+    virtual ~ReceiveBackend() = default;
+
+    virtual const char* name() const = 0;
+    // Soketleri ve bildirim fd'lerini kaydet (initialize() thread'i)
+    virtual bool start(int epoll_fd, const std::map<int, uint8_t>& sockets) = 0;
+    // Alımı başlat (worker thread'i; io_uring istekleri gönderen thread'e bağlıdır)
+    virtual bool arm() { return true; }
+    // epoll'de okunabilir olan fd bu backend'e aitse datagramları işler ve true döner
+    virtual bool on_readable(int fd) = 0;
+    // false ise backend alımı sürdüremiyor; engine epoll'e geçer
+    virtual bool healthy() const { return true; }
+
+    void set_handler(BatchHandler handler) { handler_ = std::move(handler); }
+
+protected:
+    BatchHandler handler_;
+};
+
+// epoll + recvmmsg: her okunabilir soket için RECV_BATCH_SIZE'lık slab'a toplu alım.
+// Edge-triggered kayıtta her olayda soket EAGAIN'e kadar boşaltılır. UDP_GRO açıkken
+// slab GRO_BATCH_SIZE x GRO_SLOT_SIZE olur ve segment boyutu cmsg'den okunur.
+class EpollReceiveBackend : public ReceiveBackend {
+public:
+    explicit EpollReceiveBackend(const ReceiveOptions& options = ReceiveOptions());
+
+    const char* name() const override { return "epoll"; }
+    bool start(int epoll_fd, const std::map<int, uint8_t>& sockets) override;
+    bool on_readable(int fd) override;
+
+private:
+    ReceiveOptions options_;
+    size_t batch_size_;
+    size_t slot_size_;
+    std::map<int, uint8_t> sockets_;          // socket_fd -> tunnel_id
+    std::vector<uint8_t> slab_;               // batch_size_ x slot_size_
+    std::vector<struct iovec> iovecs_;
+    std::vector<uint64_t> control_;           // UDP_GRO cmsg alanları (hizalı)
+    std::vector<struct mmsghdr> msgs_;
+    std::vector<sockaddr_in> addrs_;
+    std::vector<ReceivedDatagram> batch_;
+};
+
+// İstenen backend'i oluşturup başlatır; io_uring kullanılamıyorsa epoll döner
+std::unique_ptr<ReceiveBackend> create_receive_backend(ReceiveBackendType type, int epoll_fd,
+                                                       const std::map<int, uint8_t>& sockets,
+                                                       ReceiveBackend::BatchHandler handler,
+                                                       const ReceiveOptions& options = ReceiveOptions());
@@ -0,0 +1,62 @@
+// retransmit_cache.cpp - NovaEngine yeniden gönderim önbelleği implementation
+#include "retransmit_cache.h"
+#include <cstring>
+#include <arpa/inet.h>
+
+RetransmitCache::RetransmitCache(size_t capacity, size_t max_slice_size)
+    : max_slice_size_(max_slice_size), slots_(std::max<size_t>(capacity, 1)),
+      arena_(slots_.size() * max_slice_size), sequence_(0) {
+}
+
+void RetransmitCache::store(const SliceHeader& header, const uint8_t* payload, size_t size) {
+    if (size > max_slice_size_) return;
+
+    const uint32_t frame_id = ntohl(header.frame_id);
+    const bool is_parity = (header.reserved & SLICE_FLAG_PARITY) != 0;
+    const uint16_t index = is_parity ? ntohs(header.total_slices) + ntohs(header.slice_id) : ntohs(header.slice_id);
+
+    // İlk slice'ı gelen frame'in halka konumunu kaydet
+    auto& frame = frames_[frame_id & (FRAME_WINDOW_SIZE - 1)];
+    if (!frame.valid || frame.frame_id != frame_id) {
+        frame.valid = true;
+        frame.frame_id = frame_id;
+        frame.first_sequence = sequence_;
+        frame.first_index = index;
+    }
+
+    const size_t position = sequence_++ % slots_.size();
+    auto& slot = slots_[position];
+    slot.valid = true;
+    slot.frame_id = frame_id;
+    slot.index = index;
+    slot.header = header;
+    slot.size = static_cast<uint16_t>(size);
+    std::memcpy(arena_.data() + position * max_slice_size_, payload, size);
+}
+
+bool RetransmitCache::find(uint32_t frame_id, uint16_t slice_id, bool is_parity,
+                           SliceHeader& header, const uint8_t*& payload, size_t& size) const {
+    const auto& frame = frames_[frame_id & (FRAME_WINDOW_SIZE - 1)];
+    if (!frame.valid || frame.frame_id != frame_id) return false;
+
+    // Parity indeksi için total_slices ilk slot'un header'ından okunur
+    const auto& first = slots_[frame.first_sequence % slots_.size()];
+    uint16_t index = slice_id;
+    if (is_parity) {
+        if (!first.valid || first.frame_id != frame_id) return false;
+        index = ntohs(first.header.total_slices) + slice_id;
+    }
+    if (index < frame.first_index) return false;
+
+    const uint64_t sequence = frame.first_sequence + (index - frame.first_index);
+    if (sequence >= sequence_ || sequence_ - sequence > slots_.size()) return false; // Üzerine yazılmış
+
+    const size_t position = sequence % slots_.size();
+    const auto& slot = slots_[position];
+    if (!slot.valid || slot.frame_id != frame_id || slot.index != index) return false;
+
+    header = slot.header;
+    payload = arena_.data() + position * max_slice_size_;
+    size = slot.size;
+    return true;
+}
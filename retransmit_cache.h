@@ -0,0 +1,50 @@
+// retransmit_cache.h - NovaEngine gönderici tarafı yeniden gönderim önbelleği
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "reassembly_engine.h"
+
+// Gönderilen slice'ların (frame_id, slice_id) ile aranabilen sınırlı kopyası. Slice'lar
+// önceden ayrılmış bir halkaya eklenme sırasıyla yazılır; halka dolunca en eski slice'ların
+// üzerine yazılır (FIFO). Bir frame'in slice'ları art arda eklendiği sürece arama O(1)'dir
+// ve çalışma sırasında allocation yapılmaz. Tek thread'den kullanılır.
+class RetransmitCache {
+public:
+    explicit RetransmitCache(size_t capacity = 2048, size_t max_slice_size = RECV_SLOT_SIZE);
+
+    // Kablo formatındaki (network byte order) header ve payload'ı sakla
+    void store(const SliceHeader& header, const uint8_t* payload, size_t size);
+
+    // Veri slice'ını bul (parity için is_parity = true ve slice_id = parity indeksi)
+    bool find(uint32_t frame_id, uint16_t slice_id, bool is_parity,
+              SliceHeader& header, const uint8_t*& payload, size_t& size) const;
+
+    size_t capacity() const { return slots_.size(); }
+    uint64_t stored_count() const { return sequence_; }
+
+private:
+    struct Slot {
+        bool valid = false;
+        uint32_t frame_id = 0;
+        uint16_t index = 0;         // Veri slice'ı: slice_id, parity: total_slices + parity indeksi
+        SliceHeader header{};
+        uint16_t size = 0;
+    };
+
+    // Frame'in ilk eklenen slice'ının halka sırası
+    struct FrameIndex {
+        bool valid = false;
+        uint32_t frame_id = 0;
+        uint64_t first_sequence = 0;
+        uint16_t first_index = 0;
+    };
+
+    size_t max_slice_size_;
+    std::vector<Slot> slots_;
+    std::vector<uint8_t> arena_;                            // capacity x max_slice_size
+    std::array<FrameIndex, FRAME_WINDOW_SIZE> frames_;
+    uint64_t sequence_;
+};
@@ -0,0 +1,80 @@
+// slice_nack.h - NovaEngine eksik slice bildirimi (NACK) paket formatı
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <arpa/inet.h>
+
+// NACK paketi: 12 byte başlık + bitmap (network byte order). İlk 10 byte SliceHeader ile
+// hizalıdır; total_slices konumundaki 0 değeri paketi veri slice'ından ayırır.
+// Bitmap'in i. biti (byte i / 8, bit i % 8) base_slice + i numaralı veri slice'ını ister.
+struct NackHeader {
+    uint32_t frame_id;
+    uint16_t base_slice;    // Bitmap'in ilk biti
+    uint16_t control;       // Her zaman 0 (SliceHeader::total_slices)
+    uint8_t tunnel_id;      // Yeniden gönderim için istenen tünel (NACK'in gönderildiği tünel)
+    uint8_t type;           // PACKET_TYPE_NACK
+    uint16_t bitmap_bytes;
+} __attribute__((packed));
+
+constexpr uint8_t PACKET_TYPE_NACK = 3;        // Probe tipleri 1 ve 2
+constexpr size_t NACK_MAX_BITMAP_BYTES = 128;  // MAX_SLICES_PER_FRAME / 8
+constexpr size_t NACK_MAX_PACKET_SIZE = sizeof(NackHeader) + NACK_MAX_BITMAP_BYTES;
+
+// Eksik slice'lar için NACK paketi oluştur; for_each_missing(fn) artan sırada slice id verir.
+// Paket boyutunu döndürür (eksik slice yoksa 0).
+template <typename ForEachMissing>
+inline size_t build_nack(uint8_t* packet, uint32_t frame_id, uint8_t tunnel_id, ForEachMissing&& for_each_missing) {
+    NackHeader* header = reinterpret_cast<NackHeader*>(packet);
+    uint8_t* bitmap = packet + sizeof(NackHeader);
+    std::memset(bitmap, 0, NACK_MAX_BITMAP_BYTES);
+
+    bool first = true;
+    uint16_t base = 0;
+    size_t bytes = 0;
+    for_each_missing([&](uint16_t slice_id) {
+        if (first) {
+            base = slice_id;
+            first = false;
+        }
+        const size_t bit = slice_id - base;
+        if (bit >= NACK_MAX_BITMAP_BYTES * 8) return;
+        bitmap[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+        bytes = (bit >> 3) + 1;
+    });
+    if (first) return 0;
+
+    header->frame_id = htonl(frame_id);
+    header->base_slice = htons(base);
+    header->control = 0;
+    header->tunnel_id = tunnel_id;
+    header->type = PACKET_TYPE_NACK;
+    header->bitmap_bytes = htons(static_cast<uint16_t>(bytes));
+    return sizeof(NackHeader) + bytes;
+}
+
+inline bool is_nack(const uint8_t* packet, size_t length) {
+    if (length < sizeof(NackHeader)) return false;
+    const NackHeader* header = reinterpret_cast<const NackHeader*>(packet);
+    const size_t bytes = ntohs(header->bitmap_bytes);
+    return header->control == 0 && header->type == PACKET_TYPE_NACK &&
+           bytes <= NACK_MAX_BITMAP_BYTES && length == sizeof(NackHeader) + bytes;
+}
+
+// NACK'teki slice id'lerini sırayla ver (paket is_nack ile doğrulanmış olmalı)
+template <typename Fn>
+inline void for_each_nacked_slice(const uint8_t* packet, Fn&& fn) {
+    const NackHeader* header = reinterpret_cast<const NackHeader*>(packet);
+    const uint8_t* bitmap = packet + sizeof(NackHeader);
+    const uint32_t frame_id = ntohl(header->frame_id);
+    const uint16_t base = ntohs(header->base_slice);
+    const size_t bytes = ntohs(header->bitmap_bytes);
+    for (size_t i = 0; i < bytes; ++i) {
+        uint8_t bits = bitmap[i];
+        while (bits) {
+            fn(frame_id, static_cast<uint16_t>(base + i * 8 + __builtin_ctz(bits)));
+            bits &= bits - 1;
+        }
+    }
+}
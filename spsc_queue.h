@@ -0,0 +1,80 @@
+// spsc_queue.h - NovaEngine tek üretici / tek tüketici lock-free kuyruk
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+// Sabit kapasiteli halka kuyruk. Bir thread yalnızca try_push, bir thread yalnızca
+// try_pop çağırır; hiçbir işlemde kilit veya allocation yoktur.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : slots_(round_up_pow2(capacity)), mask_(slots_.size() - 1), head_(0), tail_(0) {}
+
+    bool try_push(T&& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return false; // Kuyruk dolu
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false; // Kuyruk boş
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Yerinde yazım: boş slotu döndürür (kuyruk doluysa nullptr), doldurduktan sonra commit_push()
+    T* try_reserve() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    void commit_push() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Yerinde okuma: baştaki elemanı döndürür (kuyruk boşsa nullptr), işlendikten sonra pop_front()
+    T* front() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    void pop_front() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_; // Tüketici konumu
+    alignas(64) std::atomic<size_t> tail_; // Üretici konumu
+};
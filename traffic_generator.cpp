@@ -0,0 +1,365 @@
+// traffic_generator.cpp - NovaEngine deterministik slice trafiği üreteci implementation
+#include "traffic_generator.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/udp.h>
+
+SliceHeader GeneratedSlice::header() const {
+    SliceHeader header;
+    header.frame_id = htonl(frame_id);
+    header.slice_id = htons(slice_id);
+    header.total_slices = htons(total_slices);
+    header.tunnel_id = tunnel_id;
+    header.reserved = static_cast<uint8_t>((is_parity ? SLICE_FLAG_PARITY : 0) | (fec_parity & SLICE_FEC_PARITY_MASK));
+    header.frame_flags = frame_flags;
+    header.reference_distance = reference_distance;
+    return header;
+}
+
+TrafficGenerator::TrafficGenerator(const TrafficConfig& config)
+    : config_(config), rng_(config.seed), unit_(0.0, 1.0), sequence_(0), generated_(0), dropped_(0) {
+    if (config_.tunnel_delay_ms.empty()) {
+        config_.tunnel_delay_ms.push_back(0.0);
+    }
+    config_.slice_size = std::max<size_t>(1, config_.slice_size);
+    config_.frame_size = std::max<size_t>(1, config_.frame_size);
+
+    total_slices_ = static_cast<uint16_t>(std::min<size_t>(
+        (config_.frame_size + config_.slice_size - 1) / config_.slice_size, MAX_SLICES_PER_FRAME));
+    config_.frame_size = std::min(config_.frame_size, static_cast<size_t>(total_slices_) * config_.slice_size);
+    if (config_.gop_size == 0 || config_.keyframe_fec_parity == 0) {
+        config_.keyframe_fec_parity = config_.fec_parity;
+    }
+    parity_slices_ = FecCodec::parity_slice_count(total_slices_, config_.fec_parity);
+    key_parity_slices_ = FecCodec::parity_slice_count(total_slices_, config_.keyframe_fec_parity);
+
+    frame_interval_ns_ = config_.frame_rate > 0.0 ? static_cast<uint64_t>(1e9 / config_.frame_rate) : 0;
+    config_.pacing = std::min(std::max(config_.pacing, 0.0), 1.0);
+    slice_gap_ns_ = static_cast<uint64_t>(frame_interval_ns_ * config_.pacing) /
+                    (total_slices_ + std::max(parity_slices_, key_parity_slices_));
+
+    for (double delay_ms : config_.tunnel_delay_ms) {
+        tunnel_delay_ns_.push_back(static_cast<uint64_t>(delay_ms * 1e6));
+    }
+
+    // Şablon frame'ler ve parity'leri (seed'den türetilen içerik)
+    FecCodec codec;
+    std::mt19937_64 content(config_.seed ^ 0x9E3779B97F4A7C15ull);
+    templates_.resize(TEMPLATE_COUNT);
+    parity_.resize(TEMPLATE_COUNT);
+    key_parity_.resize(TEMPLATE_COUNT);
+    for (size_t t = 0; t < TEMPLATE_COUNT; ++t) {
+        templates_[t].resize(config_.frame_size);
+        for (auto& byte : templates_[t]) {
+            byte = static_cast<uint8_t>(content());
+        }
+        if (parity_slices_ > 0) {
+            codec.encode(templates_[t].data(), templates_[t].size(), static_cast<uint32_t>(config_.slice_size),
+                         total_slices_, config_.fec_parity, parity_[t]);
+        }
+        if (key_parity_slices_ > 0 && config_.keyframe_fec_parity != config_.fec_parity) {
+            codec.encode(templates_[t].data(), templates_[t].size(), static_cast<uint32_t>(config_.slice_size),
+                         total_slices_, config_.keyframe_fec_parity, key_parity_[t]);
+        }
+    }
+}
+
+uint64_t TrafficGenerator::frame_send_time(uint32_t frame_id) const {
+    return static_cast<uint64_t>(frame_id) * frame_interval_ns_;
+}
+
+void TrafficGenerator::push_event(uint64_t send_ns, uint32_t frame_id, uint16_t index) {
+    const uint8_t tunnel = static_cast<uint8_t>(rng_() % tunnel_delay_ns_.size());
+    uint64_t arrival = send_ns + tunnel_delay_ns_[tunnel];
+    if (config_.jitter_ms > 0.0) {
+        arrival += static_cast<uint64_t>(unit_(rng_) * config_.jitter_ms * 1e6);
+    }
+    if (config_.reorder > 0.0 && unit_(rng_) < config_.reorder) {
+        // Sonraki 1..reorder_depth slice'ın arkasına düşür
+        const uint64_t gap = std::max<uint64_t>(slice_gap_ns_, 1);
+        arrival += gap * (1 + rng_() % std::max<uint32_t>(config_.reorder_depth, 1));
+    }
+    pending_.push(Event{arrival, sequence_++, frame_id, index, tunnel});
+    generated_++;
+}
+
+void TrafficGenerator::generate_frame(uint32_t frame_id) {
+    const uint64_t frame_time = frame_send_time(frame_id);
+    const uint16_t count = slice_count(frame_id);
+
+    for (uint16_t index = 0; index < count; ++index) {
+        if (config_.loss > 0.0 && unit_(rng_) < config_.loss) {
+            dropped_++;
+            continue;
+        }
+        const uint64_t send_time = frame_time + index * slice_gap_ns_;
+        push_event(send_time, frame_id, index);
+        if (config_.duplicate > 0.0 && unit_(rng_) < config_.duplicate) {
+            push_event(send_time, frame_id, index);
+        }
+    }
+}
+
+bool TrafficGenerator::next_arrival(uint64_t now_ns, GeneratedSlice& out) {
+    if (pending_.empty() || pending_.top().arrival_ns > now_ns) {
+        return false;
+    }
+    const Event event = pending_.top();
+    pending_.pop();
+
+    slice(event.frame_id, event.index, out);
+    out.arrival_ns = event.arrival_ns;
+    out.tunnel_id = event.tunnel_id;
+    return true;
+}
+
+void TrafficGenerator::slice(uint32_t frame_id, uint16_t index, GeneratedSlice& out) const {
+    const size_t tmpl = frame_id % TEMPLATE_COUNT;
+    out.arrival_ns = 0;
+    out.frame_id = frame_id;
+    out.total_slices = total_slices_;
+    out.tunnel_id = 0;
+    const bool keyframe = is_keyframe(frame_id);
+    out.fec_parity = keyframe ? config_.keyframe_fec_parity : config_.fec_parity;
+    out.frame_flags = 0;
+    out.reference_distance = 0;
+    if (keyframe) {
+        out.frame_flags = FRAME_FLAG_KEYFRAME | FRAME_FLAG_REFERENCE;
+    } else if (config_.gop_size > 0) {
+        // GOP içinde her frame bir öncekine bağımlı; GOP'un son frame'ine bağımlı olan yok
+        out.frame_flags = FRAME_FLAG_DEPENDENT;
+        if ((frame_id + 1) % config_.gop_size != 0) out.frame_flags |= FRAME_FLAG_REFERENCE;
+        out.reference_distance = 1;
+    }
+    out.is_parity = index >= total_slices_;
+    if (out.is_parity) {
+        out.slice_id = index - total_slices_;
+        const bool key_parity = keyframe && config_.keyframe_fec_parity != config_.fec_parity;
+        const auto& payload = (key_parity ? key_parity_ : parity_)[tmpl][out.slice_id];
+        out.data = payload.data();
+        out.data_size = payload.size();
+    } else {
+        out.slice_id = index;
+        const size_t offset = static_cast<size_t>(index) * config_.slice_size;
+        out.data = templates_[tmpl].data() + offset;
+        out.data_size = std::min(config_.slice_size, config_.frame_size - offset);
+    }
+}
+
+bool TrafficGenerator::verify_frame(uint32_t frame_id, const std::vector<uint8_t>& data) const {
+    return data == templates_[frame_id % TEMPLATE_COUNT];
+}
+
+LoopbackSender::LoopbackSender(const std::string& ip, const std::vector<int>& ports)
+    : sock_fd_(socket(AF_INET, SOCK_DGRAM, 0)), queued_(0), sent_(0), failed_(0), segmentation_(false),
+      feedback_jitter_ms_(0.0), echoes_(0), retransmits_(0) {
+    for (int port : ports) {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+        addresses_.push_back(addr);
+    }
+    
+    // Yüksek hızda gönderici tarafında düşmeyi azalt
+    int buffer_size = 4 * 1024 * 1024;
+    setsockopt(sock_fd_, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+}
+
+LoopbackSender::~LoopbackSender() {
+    if (sock_fd_ >= 0) {
+        close(sock_fd_);
+    }
+}
+
+void LoopbackSender::queue(const GeneratedSlice& slice) {
+    queue_raw(slice.header(), slice.data, slice.data_size, slice.tunnel_id);
+}
+
+void LoopbackSender::cache(const GeneratedSlice& slice) {
+    retransmit_cache_.store(slice.header(), slice.data, slice.data_size);
+}
+
+void LoopbackSender::queue_raw(const SliceHeader& header, const uint8_t* data, size_t size, uint8_t tunnel_id) {
+    if (addresses_.empty()) return;
+    
+    headers_[queued_] = header;
+    headers_[queued_].tunnel_id = tunnel_id;
+    iovecs_[queued_][0].iov_base = &headers_[queued_];
+    iovecs_[queued_][0].iov_len = sizeof(SliceHeader);
+    iovecs_[queued_][1].iov_base = const_cast<uint8_t*>(data);
+    iovecs_[queued_][1].iov_len = size;
+    
+    auto& msg = msgs_[queued_].msg_hdr;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addresses_[tunnel_id % addresses_.size()];
+    msg.msg_namelen = sizeof(sockaddr_in);
+    msg.msg_iov = iovecs_[queued_];
+    msg.msg_iovlen = 2;
+    
+    if (++queued_ == BATCH_SIZE) {
+        flush();
+    }
+}
+
+size_t LoopbackSender::flush() {
+    if (segmentation_) {
+        return flush_segmented();
+    }
+    
+    size_t sent = 0;
+    while (sent < queued_) {
+        int result = sendmmsg(sock_fd_, msgs_ + sent, queued_ - sent, 0);
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR) continue;
+            failed_ += queued_ - sent; // Gönderilemeyenler kayıp sayılır
+            break;
+        }
+        sent += result;
+    }
+    sent_ += sent;
+    queued_ = 0;
+    return sent;
+}
+
+size_t LoopbackSender::flush_segmented() {
+    // Aynı hedefe giden ardışık slice'ları grupla; kısa slice yalnızca grubun sonunda olabilir
+    size_t groups = 0;
+    for (size_t first = 0; first < queued_; ++groups) {
+        const size_t segment = iovecs_[first][0].iov_len + iovecs_[first][1].iov_len;
+        size_t last = first + 1;
+        size_t total = segment;
+        while (last < queued_ && last - first < GSO_MAX_SEGMENTS &&
+               msgs_[last].msg_hdr.msg_name == msgs_[first].msg_hdr.msg_name) {
+            const size_t size = iovecs_[last][0].iov_len + iovecs_[last][1].iov_len;
+            if (size > segment || total + size > GSO_MAX_BYTES) break;
+            total += size;
+            ++last;
+            if (size < segment) break;
+        }
+        
+        // iovecs_ satırları bellekte ardışık, grup tek iovec dizisi olarak verilir
+        auto& msg = gso_msgs_[groups].msg_hdr;
+        msg = msgs_[first].msg_hdr;
+        msg.msg_iovlen = 2 * (last - first);
+        if (last - first > 1) {
+            msg.msg_control = gso_control_[groups];
+            msg.msg_controllen = sizeof(gso_control_[groups]);
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t segment_size = static_cast<uint16_t>(segment);
+            memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        }
+        gso_counts_[groups] = last - first;
+        first = last;
+    }
+    
+    size_t sent_groups = 0;
+    size_t sent = 0;
+    while (sent_groups < groups) {
+        int result = sendmmsg(sock_fd_, gso_msgs_ + sent_groups, groups - sent_groups, 0);
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR) continue;
+            failed_ += queued_ - sent; // Gönderilemeyenler kayıp sayılır
+            break;
+        }
+        for (int i = 0; i < result; ++i) {
+            sent += gso_counts_[sent_groups + i];
+        }
+        sent_groups += result;
+    }
+    sent_ += sent;
+    queued_ = 0;
+    return sent;
+}
+
+void LoopbackSender::set_feedback_delays(const std::vector<double>& tunnel_delay_ms, double jitter_ms, uint64_t seed) {
+    feedback_delay_ns_.clear();
+    for (double delay_ms : tunnel_delay_ms) {
+        feedback_delay_ns_.push_back(static_cast<uint64_t>(delay_ms * 1e6));
+    }
+    feedback_jitter_ms_ = jitter_ms;
+    feedback_rng_.seed(seed);
+}
+
+uint64_t LoopbackSender::feedback_delay(uint8_t tunnel_id) {
+    uint64_t delay = feedback_delay_ns_.empty() ? 0 : feedback_delay_ns_[tunnel_id % feedback_delay_ns_.size()];
+    if (feedback_jitter_ms_ > 0.0) {
+        delay += static_cast<uint64_t>(std::uniform_real_distribution<double>(0.0, feedback_jitter_ms_ * 1e6)(feedback_rng_));
+    }
+    return delay;
+}
+
+size_t LoopbackSender::poll_feedback() {
+    uint8_t buffer[RECV_SLOT_SIZE];
+    sockaddr_in source;
+    socklen_t source_len = sizeof(source);
+    const uint64_t now = probe_clock_ns();
+    
+    // Gelen probe ve NACK'leri tünel gecikmesine göre beklet
+    ssize_t length;
+    while ((length = recvfrom(sock_fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                              reinterpret_cast<sockaddr*>(&source), &source_len)) > 0) {
+        source_len = sizeof(source);
+        PendingFeedback pending;
+        pending.target = source;
+        
+        if (TunnelProber::is_probe(buffer, length)) {
+            pending.is_echo = true;
+            std::memcpy(&pending.packet, buffer, sizeof(ProbePacket));
+            pending.stamp_ns = now + feedback_delay(pending.packet.tunnel_id);
+            pending.send_ns = pending.stamp_ns + feedback_delay(pending.packet.tunnel_id);
+            pending_feedback_.push_back(pending);
+        } else if (is_nack(buffer, length)) {
+            const uint8_t tunnel_id = reinterpret_cast<const NackHeader*>(buffer)->tunnel_id;
+            // NACK'in gidişi ve yeniden gönderilen slice'ın dönüşü
+            const uint64_t send_ns = now + feedback_delay(tunnel_id) + feedback_delay(tunnel_id);
+            pending.is_echo = false;
+            pending.tunnel_id = tunnel_id;
+            pending.stamp_ns = 0;
+            pending.send_ns = send_ns;
+            for_each_nacked_slice(buffer, [&](uint32_t frame_id, uint16_t slice_id) {
+                pending.frame_id = frame_id;
+                pending.slice_id = slice_id;
+                pending_feedback_.push_back(pending);
+            });
+        }
+    }
+    
+    // Zamanı gelen yanıtları gönder
+    size_t sent = 0;
+    for (size_t i = 0; i < pending_feedback_.size();) {
+        auto& pending = pending_feedback_[i];
+        if (pending.send_ns > now) {
+            ++i;
+            continue;
+        }
+        if (pending.is_echo) {
+            if (make_probe_echo(reinterpret_cast<uint8_t*>(&pending.packet), sizeof(ProbePacket), pending.stamp_ns)) {
+                sendto(sock_fd_, &pending.packet, sizeof(ProbePacket), MSG_DONTWAIT,
+                       reinterpret_cast<const sockaddr*>(&pending.target), sizeof(pending.target));
+                echoes_++;
+                sent++;
+            }
+        } else {
+            SliceHeader header;
+            const uint8_t* payload;
+            size_t size;
+            if (retransmit_cache_.find(pending.frame_id, pending.slice_id, false, header, payload, size)) {
+                queue_raw(header, payload, size, pending.tunnel_id);
+                retransmits_++;
+                sent++;
+            }
+        }
+        pending = pending_feedback_.back();
+        pending_feedback_.pop_back();
+    }
+    flush();
+    return sent;
+}
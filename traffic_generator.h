@@ -0,0 +1,195 @@
+// traffic_generator.h - NovaEngine deterministik slice trafiği üreteci (test/benchmark)
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "reassembly_engine.h"
+#include "tunnel_probe.h"
+#include "retransmit_cache.h"
+
+// Üretilecek trafiğin tanımı; aynı seed aynı slice dizisini üretir
+struct TrafficConfig {
+    uint64_t seed = 1;
+    size_t frame_size = 64 * 1024;            // Frame başına byte
+    size_t slice_size = 1200;                 // Slice payload boyutu (son slice daha kısa olabilir)
+    uint8_t fec_parity = 0;                   // Blok başına parity (0 = FEC yok)
+    uint32_t gop_size = 0;                    // Keyframe aralığı, frame (0 = frame türü gönderilmez)
+    uint8_t keyframe_fec_parity = 0;          // Keyframe'lerin blok başına parity'si (0 = fec_parity)
+    double frame_rate = 60.0;                 // Sanal zamanda frame/saniye
+    double pacing = 1.0;                      // Frame aralığının slice gönderimine yayılan oranı (0..1)
+    double loss = 0.0;                        // Slice kayıp olasılığı (0..1)
+    double duplicate = 0.0;                   // Slice'ın iki kez gelme olasılığı
+    double reorder = 0.0;                     // Slice'ın geciktirilip sonrakilerin arkasına düşme olasılığı
+    uint32_t reorder_depth = 8;               // Geciktirilen slice en fazla kaç slice aralığı geriye düşer
+    std::vector<double> tunnel_delay_ms{0.0}; // Tünel başına tek yön gecikme (tünel sayısını da belirler)
+    double jitter_ms = 0.0;                   // Her slice'a eklenen [0, jitter) gecikme
+};
+
+// Sanal varış zamanı gelmiş bir slice; payload generator'ın şablon frame'ine işaret eder
+struct GeneratedSlice {
+    uint64_t arrival_ns = 0;      // Sanal zaman (trafiğin başından itibaren)
+    uint32_t frame_id = 0;
+    uint16_t slice_id = 0;
+    uint16_t total_slices = 0;
+    uint8_t tunnel_id = 0;
+    bool is_parity = false;
+    uint8_t fec_parity = 0;
+    uint8_t frame_flags = 0;          // FRAME_FLAG_* (gop_size = 0 ise 0)
+    uint8_t reference_distance = 0;
+    const uint8_t* data = nullptr;
+    size_t data_size = 0;
+
+    // Kablo formatında SliceHeader (network byte order)
+    SliceHeader header() const;
+};
+
+// Frame'leri sanal zamanda frame_rate ile gönderir, kayıp/duplicate/reorder/tünel gecikmesini
+// uygular ve slice'ları varış zamanı sırasıyla verir. Payload'lar önceden hazırlanmış şablon
+// frame'lerdendir (FEC parity dahil), böylece üretim yolu allocation yapmaz.
+// gop_size > 0 ise her gop_size frame'de bir keyframe gönderilir; aradaki frame'ler bir
+// öncekine bağımlıdır, GOP'un son frame'i referans değildir.
+class TrafficGenerator {
+public:
+    explicit TrafficGenerator(const TrafficConfig& config);
+
+    // Frame'in slice'larını kuyruğa ekle (gönderim zamanı frame_id / frame_rate)
+    void generate_frame(uint32_t frame_id);
+
+    // Varış zamanı <= now_ns olan sıradaki slice'ı ver
+    bool next_arrival(uint64_t now_ns, GeneratedSlice& out);
+    // Frame'in index numaralı slice'ı (kayıptan bağımsız; index >= total_slices parity)
+    void slice(uint32_t frame_id, uint16_t index, GeneratedSlice& out) const;
+    uint16_t slice_count(uint32_t frame_id) const {
+        return total_slices_ + (is_keyframe(frame_id) ? key_parity_slices_ : parity_slices_);
+    }
+    bool is_keyframe(uint32_t frame_id) const { return config_.gop_size > 0 && frame_id % config_.gop_size == 0; }
+    bool empty() const { return pending_.empty(); }
+    uint64_t next_arrival_time() const { return pending_.empty() ? UINT64_MAX : pending_.top().arrival_ns; }
+
+    uint64_t frame_send_time(uint32_t frame_id) const;
+    uint16_t total_slices() const { return total_slices_; }
+    size_t tunnel_count() const { return config_.tunnel_delay_ms.size(); }
+
+    // Teslim edilen frame verisi üretilen frame ile aynı mı
+    bool verify_frame(uint32_t frame_id, const std::vector<uint8_t>& data) const;
+
+    uint64_t generated_slices() const { return generated_; }
+    uint64_t dropped_slices() const { return dropped_; }
+
+private:
+    struct Event {
+        uint64_t arrival_ns;
+        uint64_t sequence;          // Aynı varış zamanında üretim sırasını koru
+        uint32_t frame_id;
+        uint16_t index;             // < total_slices: veri slice'ı, sonrası parity
+        uint8_t tunnel_id;
+        bool operator>(const Event& other) const {
+            return arrival_ns != other.arrival_ns ? arrival_ns > other.arrival_ns : sequence > other.sequence;
+        }
+    };
+
+    static constexpr size_t TEMPLATE_COUNT = 8;   // frame_id % TEMPLATE_COUNT şablonu kullanır
+
+    TrafficConfig config_;
+    uint16_t total_slices_;
+    uint16_t parity_slices_;
+    uint16_t key_parity_slices_;
+    uint64_t frame_interval_ns_;
+    uint64_t slice_gap_ns_;
+    std::vector<std::vector<uint8_t>> templates_;                   // Frame verisi
+    std::vector<std::vector<std::vector<uint8_t>>> parity_;         // Şablon başına parity payload'ları
+    std::vector<std::vector<std::vector<uint8_t>>> key_parity_;     // keyframe_fec_parity ile (ayrıysa)
+    std::vector<uint64_t> tunnel_delay_ns_;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> pending_;
+    std::mt19937_64 rng_;
+    std::uniform_real_distribution<double> unit_;
+    uint64_t sequence_;
+    uint64_t generated_;
+    uint64_t dropped_;
+
+    void push_event(uint64_t send_ns, uint32_t frame_id, uint16_t index);
+};
+
+// Üretilen slice'ları tünel portlarına (tünel i -> ports[i]) UDP ile gönderir.
+// Header ve payload iovec ile birleştirilir, gönderim sendmmsg ile toplu yapılır.
+class LoopbackSender {
+public:
+    static constexpr size_t BATCH_SIZE = 64;
+
+    LoopbackSender(const std::string& ip, const std::vector<int>& ports);
+    ~LoopbackSender();
+
+    bool is_open() const { return sock_fd_ >= 0; }
+
+    // Gönderilecek slice'ı tampona ekle (dolarsa gönderir)
+    void queue(const GeneratedSlice& slice);
+    // Tampondaki slice'ları gönder, gönderilen sayıyı döndürür
+    size_t flush();
+    
+    // UDP_SEGMENT (GSO): aynı tünele ardışık giden eşit boyutlu slice'lar tek sendmsg ile
+    // gönderilir. Alıcıda UDP_GRO açıksa birleşik datagram olarak gelirler.
+    void set_segmentation(bool enabled) { segmentation_ = enabled; }
+    
+    // Slice'ı yeniden gönderim önbelleğine ekle (ağda kaybolsa da NACK ile istenebilir)
+    void cache(const GeneratedSlice& slice);
+    
+    // Engine'den gelen probe ve NACK'leri yanıtla. Yanıtlar tünelin gecikmesi kadar tutulur
+    // (gidiş) ve aynı süre daha tutulup (dönüş) gönderilir; RTT = 2 * gecikme + jitter.
+    // Probe echo'ları gidiş sonunda damgalanır. NACK'lenen slice'lar önbellekten, NACK'in
+    // geldiği tünelden (alıcının seçtiği en düşük RTT'li yol) gönderilir.
+    void set_feedback_delays(const std::vector<double>& tunnel_delay_ms, double jitter_ms, uint64_t seed = 1);
+    size_t poll_feedback();
+
+    uint64_t sent_count() const { return sent_; }
+    uint64_t failed_count() const { return failed_; }
+    uint64_t echo_count() const { return echoes_; }
+    uint64_t retransmit_count() const { return retransmits_; }
+
+private:
+    int sock_fd_;
+    std::vector<sockaddr_in> addresses_;
+    SliceHeader headers_[BATCH_SIZE];
+    struct iovec iovecs_[BATCH_SIZE][2];
+    struct mmsghdr msgs_[BATCH_SIZE];
+    size_t queued_;
+    uint64_t sent_;
+    uint64_t failed_;
+    
+    // GSO grupları (mesaj başına ardışık slice sayısı ve UDP_SEGMENT cmsg'i)
+    static constexpr size_t GSO_MAX_SEGMENTS = 64;
+    static constexpr size_t GSO_MAX_BYTES = 65507;
+    bool segmentation_;
+    struct mmsghdr gso_msgs_[BATCH_SIZE];
+    size_t gso_counts_[BATCH_SIZE];
+    alignas(struct cmsghdr) uint8_t gso_control_[BATCH_SIZE][CMSG_SPACE(sizeof(uint16_t))];
+    
+    size_t flush_segmented();
+    void queue_raw(const SliceHeader& header, const uint8_t* data, size_t size, uint8_t tunnel_id);
+    
+    // Bekletilen probe echo'ları ve yeniden gönderimler
+    struct PendingFeedback {
+        uint64_t stamp_ns;      // echo_ns damgası (gidiş gecikmesi sonrası)
+        uint64_t send_ns;       // Gönderim zamanı (dönüş gecikmesi sonrası)
+        bool is_echo;
+        sockaddr_in target;     // Echo hedefi
+        ProbePacket packet;
+        uint32_t frame_id;      // Yeniden gönderilecek slice
+        uint16_t slice_id;
+        uint8_t tunnel_id;
+    };
+    std::vector<PendingFeedback> pending_feedback_;
+    std::vector<uint64_t> feedback_delay_ns_;
+    double feedback_jitter_ms_;
+    std::mt19937_64 feedback_rng_;
+    RetransmitCache retransmit_cache_;
+    uint64_t echoes_;
+    uint64_t retransmits_;
+    
+    uint64_t feedback_delay(uint8_t tunnel_id);
+};
@@ -0,0 +1,197 @@
+// tunnel_probe.cpp - NovaEngine tünel probe/echo ölçümü implementation
+#include "tunnel_probe.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <endian.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+uint64_t probe_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool make_probe_echo(uint8_t* packet, size_t length, uint64_t now_ns) {
+    if (!TunnelProber::is_probe(packet, length)) return false;
+    ProbePacket* probe = reinterpret_cast<ProbePacket*>(packet);
+    if (probe->type != PROBE_TYPE_REQUEST) return false;
+    probe->type = PROBE_TYPE_ECHO;
+    probe->echo_ns = htobe64(now_ns);
+    return true;
+}
+
+bool TunnelProber::is_probe(const uint8_t* data, size_t length) {
+    if (length != sizeof(ProbePacket)) return false;
+    const ProbePacket* probe = reinterpret_cast<const ProbePacket*>(data);
+    return probe->route == 0 && probe->control == 0 &&
+           (probe->type == PROBE_TYPE_REQUEST || probe->type == PROBE_TYPE_ECHO);
+}
+
+int64_t TunnelProber::TunnelState::min_owd() const {
+    const size_t count = std::min(owd_count, PROBE_OWD_WINDOW);
+    return *std::min_element(owd.begin(), owd.begin() + count);
+}
+
+TunnelProber::TunnelProber(double skew_percentile)
+    : skew_percentile_(std::min(std::max(skew_percentile, 0.0), 1.0)) {
+    scratch_.reserve(PROBE_SKEW_WINDOW);
+}
+
+void TunnelProber::add_tunnel(uint8_t tunnel_id, int socket_fd) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto& tunnel = tunnels_[tunnel_id];
+    if (!tunnel.active) {
+        active_.push_back(tunnel_id);
+    }
+    tunnel.active = true;
+    tunnel.socket_fd = socket_fd;
+}
+
+void TunnelProber::observe_peer(uint8_t tunnel_id, const sockaddr_in& peer) {
+    auto& tunnel = tunnels_[tunnel_id];
+    if (!tunnel.active || peer.sin_family != AF_INET) return;
+    if (tunnel.has_peer && tunnel.peer.sin_port == peer.sin_port &&
+        tunnel.peer.sin_addr.s_addr == peer.sin_addr.s_addr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    tunnel.peer = peer;
+    tunnel.has_peer = true;
+    LOG_INFO("📡 Tunnel %d karşı ucu: %s:%d", (int)tunnel_id, inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+}
+
+void TunnelProber::send_probes(uint64_t now_ns) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    for (uint8_t tunnel_id : active_) {
+        auto& tunnel = tunnels_[tunnel_id];
+        if (!tunnel.has_peer) continue;
+
+        ProbePacket probe;
+        memset(&probe, 0, sizeof(probe));
+        probe.sequence = htons(tunnel.next_sequence++);
+        probe.tunnel_id = tunnel_id;
+        probe.type = PROBE_TYPE_REQUEST;
+        probe.origin_ns = htobe64(now_ns);
+
+        if (sendto(tunnel.socket_fd, &probe, sizeof(probe), MSG_DONTWAIT,
+                   reinterpret_cast<const sockaddr*>(&tunnel.peer), sizeof(tunnel.peer)) == sizeof(probe)) {
+            tunnel.probes_sent++;
+        }
+    }
+
+    // Echo'su kesilen tüneller hesaptan çıksın
+    update_wait_time(now_ns);
+}
+
+bool TunnelProber::handle_packet(uint8_t tunnel_id, const uint8_t* data, size_t length,
+                                 uint64_t now_ns, double& rtt_ms) {
+    if (!is_probe(data, length)) return false;
+    const ProbePacket* probe = reinterpret_cast<const ProbePacket*>(data);
+    auto& tunnel = tunnels_[tunnel_id];
+    if (probe->type != PROBE_TYPE_ECHO || !tunnel.active) return false;
+
+    const uint64_t origin_ns = be64toh(probe->origin_ns);
+    const uint64_t echo_ns = be64toh(probe->echo_ns);
+    if (origin_ns == 0 || origin_ns > now_ns) return false;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    // RTT ve varyasyonu (RFC 6298: alpha = 1/8, beta = 1/4)
+    rtt_ms = (now_ns - origin_ns) / 1e6;
+    if (tunnel.echoes_received == 0) {
+        tunnel.srtt_ms = rtt_ms;
+        tunnel.rttvar_ms = rtt_ms / 2;
+        tunnel.min_rtt_ms = rtt_ms;
+    } else {
+        tunnel.rttvar_ms = 0.75 * tunnel.rttvar_ms + 0.25 * std::fabs(tunnel.srtt_ms - rtt_ms);
+        tunnel.srtt_ms = 0.875 * tunnel.srtt_ms + 0.125 * rtt_ms;
+        tunnel.min_rtt_ms = std::min(tunnel.min_rtt_ms, rtt_ms);
+    }
+    tunnel.echoes_received++;
+    tunnel.last_echo_ns = now_ns;
+
+    // Karşı uç -> biz yönünde tek yön gecikme (saat ofseti dahil, tüneller arası farkta sadeleşir)
+    tunnel.last_owd_ns = static_cast<int64_t>(now_ns - echo_ns);
+    tunnel.owd[tunnel.owd_count++ % PROBE_OWD_WINDOW] = tunnel.last_owd_ns;
+
+    // En hızlı tünelin taban gecikmesine göre fark
+    int64_t floor = tunnel.min_owd();
+    for (uint8_t id : active_) {
+        const auto& other = tunnels_[id];
+        if (other.owd_count > 0 && now_ns - other.last_echo_ns <= static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(PROBE_STALE_AFTER).count())) {
+            floor = std::min(floor, other.min_owd());
+        }
+    }
+    tunnel.skew_ns = tunnel.last_owd_ns - floor;
+    skew_samples_[skew_count_++ % PROBE_SKEW_WINDOW] = tunnel.skew_ns;
+
+    update_wait_time(now_ns);
+    return true;
+}
+
+void TunnelProber::update_wait_time(uint64_t now_ns) {
+    const uint64_t stale_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(PROBE_STALE_AFTER).count();
+
+    // En hızlı güncel tünel (NACK yolu)
+    uint64_t fastest = 0;
+    double fastest_rtt = 0.0;
+    for (uint8_t id : active_) {
+        const auto& tunnel = tunnels_[id];
+        if (tunnel.echoes_received == 0 || now_ns - tunnel.last_echo_ns > stale_ns) continue;
+        if (fastest == 0 || tunnel.srtt_ms < fastest_rtt) {
+            fastest_rtt = tunnel.srtt_ms;
+            const uint64_t timeout_us = static_cast<uint64_t>((tunnel.srtt_ms + 4 * tunnel.rttvar_ms) * 1000);
+            fastest = (static_cast<uint64_t>(id) + 1) << 56 | timeout_us;
+        }
+    }
+    fastest_.store(fastest, std::memory_order_relaxed);
+
+    // Yalnızca güncel tüneller; hepsinde yeterli örnek olmalı
+    size_t fresh = 0;
+    for (uint8_t id : active_) {
+        const auto& tunnel = tunnels_[id];
+        if (tunnel.echoes_received == 0 || now_ns - tunnel.last_echo_ns > stale_ns) continue;
+        if (tunnel.echoes_received < PROBE_MIN_SAMPLES) {
+            wait_time_us_.store(0, std::memory_order_relaxed);
+            return;
+        }
+        fresh++;
+    }
+    if (fresh == 0 || skew_count_ == 0) {
+        wait_time_us_.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t count = std::min(skew_count_, PROBE_SKEW_WINDOW);
+    scratch_.assign(skew_samples_.begin(), skew_samples_.begin() + count);
+    size_t rank = static_cast<size_t>(std::ceil(skew_percentile_ * count));
+    rank = std::min(rank > 0 ? rank - 1 : 0, count - 1);
+    std::nth_element(scratch_.begin(), scratch_.begin() + rank, scratch_.end());
+
+    const int64_t skew_us = std::max<int64_t>(scratch_[rank], 0) / 1000;
+    wait_time_us_.store(skew_us + PROBE_WAIT_GUARD.count(), std::memory_order_relaxed);
+}
+
+std::vector<TunnelProbeStats> TunnelProber::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    std::vector<TunnelProbeStats> result;
+    for (uint8_t id : active_) {
+        const auto& tunnel = tunnels_[id];
+        TunnelProbeStats entry;
+        entry.tunnel_id = id;
+        entry.has_peer = tunnel.has_peer;
+        entry.probes_sent = tunnel.probes_sent;
+        entry.echoes_received = tunnel.echoes_received;
+        entry.rtt_ms = tunnel.srtt_ms;
+        entry.rtt_var_ms = tunnel.rttvar_ms;
+        entry.min_rtt_ms = tunnel.min_rtt_ms;
+        entry.skew_ms = tunnel.skew_ns / 1e6;
+        result.push_back(entry);
+    }
+    return result;
+}
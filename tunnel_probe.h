@@ -0,0 +1,125 @@
+// tunnel_probe.h - NovaEngine tünel RTT/jitter ve tek yön gecikme farkı ölçümü
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <netinet/in.h>
+
+// Probe paketi (26 byte, network byte order). İlk 10 byte SliceHeader ile hizalıdır:
+// total_slices konumundaki 0 değeri paketi veri slice'ından ayırır, route = 0 olduğundan
+// shard modunda reuseport yönlendirmesi probe'ları her zaman shard 0'a verir.
+struct ProbePacket {
+    uint32_t route;         // Her zaman 0 (SliceHeader::frame_id)
+    uint16_t sequence;      // Probe sıra numarası (SliceHeader::slice_id)
+    uint16_t control;       // Her zaman 0 (SliceHeader::total_slices)
+    uint8_t tunnel_id;
+    uint8_t type;           // PROBE_TYPE_REQUEST / PROBE_TYPE_ECHO
+    uint64_t origin_ns;     // İsteği gönderenin saati
+    uint64_t echo_ns;       // Yanıtlayanın saati (echo'da doldurulur)
+} __attribute__((packed));
+
+constexpr uint8_t PROBE_TYPE_REQUEST = 1;
+constexpr uint8_t PROBE_TYPE_ECHO = 2;
+
+// Ölçüm sabitleri
+constexpr size_t PROBE_OWD_WINDOW = 64;          // Tünel başına tek yön gecikme penceresi (min filtresi)
+constexpr size_t PROBE_SKEW_WINDOW = 512;        // Tüm tünellerden son gecikme farkı örnekleri
+constexpr uint32_t PROBE_MIN_SAMPLES = 8;        // Ölçüm kullanılmadan önce tünel başına gereken echo
+constexpr auto PROBE_STALE_AFTER = std::chrono::seconds(2);     // Bu süredir echo gelmeyen tünel hesaba katılmaz
+constexpr auto PROBE_WAIT_GUARD = std::chrono::microseconds(1000);
+
+// Tünel başına ölçüm özeti
+struct TunnelProbeStats {
+    uint8_t tunnel_id = 0;
+    bool has_peer = false;          // Karşı uç adresi öğrenildi mi (ilk veri paketinden)
+    uint64_t probes_sent = 0;
+    uint64_t echoes_received = 0;
+    double rtt_ms = 0.0;            // Yumuşatılmış RTT (RFC 6298 SRTT)
+    double rtt_var_ms = 0.0;        // RTT varyasyonu (RTTVAR, jitter)
+    double min_rtt_ms = 0.0;
+    double skew_ms = 0.0;           // Tek yön gecikmenin en hızlı tünele göre farkı (son örnek)
+};
+
+uint64_t probe_clock_ns();
+
+// Karşı uçta (gönderici) çağrılır: istek paketini yerinde echo'ya çevirir.
+// Paket bir probe isteği değilse false döner.
+bool make_probe_echo(uint8_t* packet, size_t length, uint64_t now_ns);
+
+// Alıcı tarafında tünel soketlerinden karşı uca periyodik probe gönderir, echo'lardan RTT,
+// RTT varyasyonu ve tüneller arası tek yön gecikme farkını (skew) ölçer. Saat farkı
+// bilinmediği için tek yön gecikme (varış - echo_ns) sabit bir ofset içerir; tüneller arası
+// farkta bu ofset sadeleşir. Bekleme süresi skew örneklerinin yüzdeliğinden türetilir.
+//
+// send_probes/handle_packet/observe_peer tek bir worker thread'inden çağrılır;
+// wait_time() her thread'den, stats() snapshot amaçlı okunabilir.
+class TunnelProber {
+public:
+    explicit TunnelProber(double skew_percentile = 0.99);
+
+    void add_tunnel(uint8_t tunnel_id, int socket_fd);
+    // Veri paketinin kaynak adresi (probe'ların hedefi)
+    void observe_peer(uint8_t tunnel_id, const sockaddr_in& peer);
+
+    void send_probes(uint64_t now_ns);
+
+    // Probe echo'sunu işle; RTT ölçüldüyse true döner
+    bool handle_packet(uint8_t tunnel_id, const uint8_t* data, size_t length, uint64_t now_ns, double& rtt_ms);
+    static bool is_probe(const uint8_t* data, size_t length);
+
+    // Ölçülen skew yüzdeliği + pay (yeterli ölçüm yoksa 0)
+    std::chrono::microseconds wait_time() const {
+        return std::chrono::microseconds(wait_time_us_.load(std::memory_order_relaxed));
+    }
+
+    // En düşük RTT'li güncel tünel ve yanıt için beklenecek süre (SRTT + 4 * RTTVAR)
+    bool fastest_tunnel(uint8_t& tunnel_id, std::chrono::microseconds& timeout) const {
+        const uint64_t packed = fastest_.load(std::memory_order_relaxed);
+        if (packed == 0) return false;
+        tunnel_id = static_cast<uint8_t>((packed >> 56) - 1);
+        timeout = std::chrono::microseconds(packed & ((uint64_t(1) << 56) - 1));
+        return true;
+    }
+
+    std::vector<TunnelProbeStats> stats() const;
+
+private:
+    struct TunnelState {
+        bool active = false;
+        int socket_fd = -1;
+        bool has_peer = false;
+        sockaddr_in peer{};
+        uint16_t next_sequence = 0;
+        uint64_t probes_sent = 0;
+        uint64_t echoes_received = 0;
+        uint64_t last_echo_ns = 0;
+        double srtt_ms = 0.0;
+        double rttvar_ms = 0.0;
+        double min_rtt_ms = 0.0;
+        int64_t last_owd_ns = 0;
+        std::array<int64_t, PROBE_OWD_WINDOW> owd{};   // Tek yön gecikme örnekleri (ofsetli)
+        size_t owd_count = 0;
+        int64_t skew_ns = 0;
+
+        int64_t min_owd() const;
+    };
+
+    double skew_percentile_;
+    std::array<TunnelState, 256> tunnels_;
+    std::vector<uint8_t> active_;                    // Eklenen tünel id'leri
+
+    std::array<int64_t, PROBE_SKEW_WINDOW> skew_samples_{};
+    size_t skew_count_ = 0;
+    std::vector<int64_t> scratch_;                   // Yüzdelik hesabı için (önceden ayrılmış)
+
+    std::atomic<int64_t> wait_time_us_{0};
+    std::atomic<uint64_t> fastest_{0};               // (tunnel_id + 1) << 56 | timeout_us, 0 = yok
+    mutable std::mutex stats_mutex_;                 // Ölçüm güncellemesi ile stats() arasında
+
+    void update_wait_time(uint64_t now_ns);
+};
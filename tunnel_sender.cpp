@@ -0,0 +1,194 @@
+// tunnel_sender.cpp - NovaEngine çok yollu gönderici implementation
+#include "tunnel_sender.h"
+#include "tunnel_probe.h"
+#include "slice_nack.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <endian.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+TunnelSender::TunnelSender(const std::string& remote_ip, const std::vector<int>& ports,
+                           const TunnelSenderConfig& config)
+    : sock_fd_(socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0)), config_(config),
+      retransmit_cache_(config.retransmit_slices), next_frame_id_(0), queued_(0),
+      frames_sent_(0), slices_sent_(0), failed_(0), echoes_(0), retransmits_(0) {
+    // Slice alıcının alım slotuna (header dahil) sığmalı
+    config_.slice_size = std::min(std::max<size_t>(config_.slice_size, 64), RECV_SLOT_SIZE - sizeof(SliceHeader));
+    if (config_.keyframe_fec_parity == 0) {
+        config_.keyframe_fec_parity = config_.fec_parity;
+    }
+
+    for (int port : ports) {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, remote_ip.c_str(), &addr.sin_addr) != 1) {
+            LOG_ERROR("HATA: Geçersiz tünel adresi: %s", remote_ip.c_str());
+            addresses_.clear();
+            break;
+        }
+        addresses_.push_back(addr);
+    }
+
+    if (sock_fd_ < 0) {
+        LOG_ERROR("HATA: Tünel gönderici socket'i açılamadı: %s", strerror(errno));
+        return;
+    }
+    // Keyframe patlamalarında gönderici tarafında düşmeyi azalt
+    int buffer_size = 4 * 1024 * 1024;
+    setsockopt(sock_fd_, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+}
+
+TunnelSender::~TunnelSender() {
+    if (sock_fd_ >= 0) {
+        close(sock_fd_);
+    }
+}
+
+bool TunnelSender::send_frame(const uint8_t* data, size_t size, uint64_t pts_ns, bool keyframe) {
+    if (!is_open()) return false;
+
+    const size_t frame_size = ACCESS_UNIT_PREFIX_SIZE + size;
+    const size_t slice_size = config_.slice_size;
+    const size_t total = (frame_size + slice_size - 1) / slice_size;
+    if (total > MAX_SLICES_PER_FRAME) {
+        LOG_WARN("UYARI: %zu byte'lık frame %zu slice'a sığmıyor, atlandı", size, (size_t)MAX_SLICES_PER_FRAME);
+        return false;
+    }
+    const uint16_t total_slices = static_cast<uint16_t>(total);
+
+    // Önek + access unit tek buffer'da (FEC kodlaması ve slice'lama için)
+    frame_.resize(frame_size);
+    const uint64_t pts_be = htobe64(pts_ns);
+    memcpy(frame_.data(), &pts_be, sizeof(pts_be));
+    memcpy(frame_.data() + ACCESS_UNIT_PREFIX_SIZE, data, size);
+
+    uint8_t fec_parity = keyframe ? config_.keyframe_fec_parity : config_.fec_parity;
+    if (fec_parity > 0 && FecCodec::parity_slice_count(total_slices, fec_parity) > FEC_MAX_PARITY_SLICES) {
+        fec_parity = 0;
+    }
+    uint16_t parity_slices = 0;
+    if (fec_parity > 0 && fec_codec_.encode(frame_.data(), frame_.size(), static_cast<uint32_t>(slice_size),
+                                            total_slices, fec_parity, parity_)) {
+        parity_slices = static_cast<uint16_t>(parity_.size());
+    } else {
+        fec_parity = 0;
+    }
+
+    const uint32_t frame_id = next_frame_id_++;
+    SliceHeader header;
+    header.frame_id = htonl(frame_id);
+    header.total_slices = htons(total_slices);
+    header.frame_flags = keyframe ? (FRAME_FLAG_KEYFRAME | FRAME_FLAG_REFERENCE)
+                                  : (FRAME_FLAG_DEPENDENT | FRAME_FLAG_REFERENCE);
+    header.reference_distance = (keyframe || frame_id == 0) ? 0 : 1;
+    if (header.reference_distance == 0) {
+        header.frame_flags &= ~FRAME_FLAG_DEPENDENT; // İlk frame'in referansı yok
+    }
+
+    // Veri slice'ları, ardından parity'ler; tüneller sırayla
+    const size_t tunnels = addresses_.size();
+    for (uint16_t index = 0; index < total_slices + parity_slices; ++index) {
+        const bool is_parity = index >= total_slices;
+        const uint8_t* payload;
+        size_t payload_size;
+        if (is_parity) {
+            header.slice_id = htons(index - total_slices);
+            payload = parity_[index - total_slices].data();
+            payload_size = parity_[index - total_slices].size();
+        } else {
+            const size_t offset = static_cast<size_t>(index) * slice_size;
+            header.slice_id = htons(index);
+            payload = frame_.data() + offset;
+            payload_size = std::min(slice_size, frame_size - offset);
+        }
+        header.reserved = static_cast<uint8_t>((is_parity ? SLICE_FLAG_PARITY : 0) | (fec_parity & SLICE_FEC_PARITY_MASK));
+
+        const uint8_t tunnel_id = static_cast<uint8_t>((frame_id + index) % tunnels);
+        header.tunnel_id = tunnel_id;
+        retransmit_cache_.store(header, payload, payload_size);
+        queue_slice(header, payload, payload_size, tunnel_id);
+    }
+    flush();
+
+    frames_sent_++;
+    return true;
+}
+
+void TunnelSender::queue_slice(const SliceHeader& header, const uint8_t* data, size_t size, uint8_t tunnel_id) {
+    headers_[queued_] = header;
+    headers_[queued_].tunnel_id = tunnel_id;
+    iovecs_[queued_][0].iov_base = &headers_[queued_];
+    iovecs_[queued_][0].iov_len = sizeof(SliceHeader);
+    iovecs_[queued_][1].iov_base = const_cast<uint8_t*>(data);
+    iovecs_[queued_][1].iov_len = size;
+
+    auto& msg = msgs_[queued_].msg_hdr;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addresses_[tunnel_id % addresses_.size()];
+    msg.msg_namelen = sizeof(sockaddr_in);
+    msg.msg_iov = iovecs_[queued_].data();
+    msg.msg_iovlen = 2;
+
+    if (++queued_ == BATCH_SIZE) {
+        flush();
+    }
+}
+
+size_t TunnelSender::flush() {
+    size_t sent = 0;
+    while (sent < queued_) {
+        int result = sendmmsg(sock_fd_, msgs_.data() + sent, queued_ - sent, 0);
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR) continue;
+            failed_ += queued_ - sent; // Gönderilemeyenler kayıp sayılır (NACK ile istenebilir)
+            break;
+        }
+        sent += result;
+    }
+    slices_sent_ += sent;
+    queued_ = 0;
+    return sent;
+}
+
+size_t TunnelSender::poll_feedback() {
+    if (!is_open()) return 0;
+
+    uint8_t buffer[NACK_MAX_PACKET_SIZE];
+    sockaddr_in source;
+    socklen_t source_len = sizeof(source);
+    size_t sent = 0;
+
+    ssize_t length;
+    while ((length = recvfrom(sock_fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                              reinterpret_cast<sockaddr*>(&source), &source_len)) > 0) {
+        source_len = sizeof(source);
+
+        if (make_probe_echo(buffer, length, probe_clock_ns())) {
+            // Echo isteğin geldiği adrese (alıcının tünel soketi) döner
+            if (sendto(sock_fd_, buffer, length, MSG_DONTWAIT,
+                       reinterpret_cast<const sockaddr*>(&source), sizeof(source)) == length) {
+                echoes_++;
+                sent++;
+            }
+        } else if (is_nack(buffer, length)) {
+            const uint8_t tunnel_id = reinterpret_cast<const NackHeader*>(buffer)->tunnel_id;
+            for_each_nacked_slice(buffer, [&](uint32_t frame_id, uint16_t slice_id) {
+                SliceHeader header;
+                const uint8_t* payload;
+                size_t size;
+                if (retransmit_cache_.find(frame_id, slice_id, false, header, payload, size)) {
+                    queue_slice(header, payload, size, tunnel_id);
+                    retransmits_++;
+                    sent++;
+                }
+            });
+        }
+    }
+    flush();
+    return sent;
+}
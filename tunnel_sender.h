@@ -0,0 +1,86 @@
+// tunnel_sender.h - NovaEngine çok yollu gönderici (encoded frame -> tünel portları)
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include "reassembly_engine.h"
+#include "fec_codec.h"
+#include "retransmit_cache.h"
+
+// Her frame'in başına eklenen yakalama zamanı (PTS, ns, big-endian). ReassemblyEngine
+// payload'ı yorumlamaz; alıcı uygulama öneki ayırıp teslim edilen buffer'ın PTS'i yapar.
+constexpr size_t ACCESS_UNIT_PREFIX_SIZE = 8;
+
+struct TunnelSenderConfig {
+    size_t slice_size = 1200;           // Slice payload boyutu (header hariç)
+    uint8_t fec_parity = 0;             // Blok başına parity (0 = FEC yok)
+    uint8_t keyframe_fec_parity = 0;    // Keyframe'ler için (0 = fec_parity)
+    size_t retransmit_slices = 8192;    // NACK için saklanan son slice sayısı
+};
+
+// ReassemblyEngine'in karşı ucu. Encoder'dan gelen her access unit'i (önek + veri) sabit
+// boyutlu slice'lara böler, FEC parity'lerini ekler ve slice'ları tünel portlarına sırayla
+// dağıtır (slice i -> tünel (frame_id + i) % tünel sayısı). Frame türü SliceHeader'da
+// taşınır: keyframe'ler KEYFRAME | REFERENCE, diğerleri bir önceki frame'e bağımlıdır
+// (encoder B-frame'siz, tek referanslı yapılandırılmalı).
+// Alıcının probe'ları anında yanıtlanır, NACK'lenen slice'lar önbellekten NACK'in geldiği
+// tünelden tekrar gönderilir. Tek thread'den kullanılır.
+// Gönderim pace edilmez: frame sendmmsg ile tek burst'te çıkar. Slice'lar tünellere dağıldığı
+// için her tünel burst'ün 1/N'ini taşır; pacing frame'in son slice'ını bir frame aralığına
+// kadar geciktirirdi. Alıcı beklemesi bu yüzden frame'in gönderim süresini (ölçülen slice
+// aralığı x slice sayısı) içerir ve tabanı bir frame aralığıdır (VideoManager).
+class TunnelSender {
+public:
+    static constexpr size_t BATCH_SIZE = 64;
+
+    TunnelSender(const std::string& remote_ip, const std::vector<int>& ports,
+                 const TunnelSenderConfig& config = TunnelSenderConfig());
+    ~TunnelSender();
+
+    bool is_open() const { return sock_fd_ >= 0 && !addresses_.empty(); }
+    size_t tunnel_count() const { return addresses_.size(); }
+
+    // Access unit'i gönder (pts_ns = yakalama zamanı). Frame slice sınırını aşarsa false.
+    bool send_frame(const uint8_t* data, size_t size, uint64_t pts_ns, bool keyframe);
+
+    // Gelen probe ve NACK'leri yanıtla, gönderilen paket sayısını döndürür
+    size_t poll_feedback();
+
+    uint64_t frames_sent() const { return frames_sent_; }
+    uint64_t slices_sent() const { return slices_sent_; }
+    uint64_t failed_count() const { return failed_; }
+    uint64_t echo_count() const { return echoes_; }
+    uint64_t retransmit_count() const { return retransmits_; }
+
+private:
+    int sock_fd_;
+    std::vector<sockaddr_in> addresses_;
+    TunnelSenderConfig config_;
+    FecCodec fec_codec_;
+    RetransmitCache retransmit_cache_;
+    uint32_t next_frame_id_;
+
+    std::vector<uint8_t> frame_;                      // Önek + access unit (yeniden kullanılır)
+    std::vector<std::vector<uint8_t>> parity_;        // Parity payload'ları (yeniden kullanılır)
+
+    // sendmmsg toplu gönderimi
+    std::array<SliceHeader, BATCH_SIZE> headers_;
+    std::array<std::array<struct iovec, 2>, BATCH_SIZE> iovecs_;
+    std::array<struct mmsghdr, BATCH_SIZE> msgs_;
+    size_t queued_;
+
+    uint64_t frames_sent_;
+    uint64_t slices_sent_;
+    uint64_t failed_;
+    uint64_t echoes_;
+    uint64_t retransmits_;
+
+    void queue_slice(const SliceHeader& header, const uint8_t* data, size_t size, uint8_t tunnel_id);
+    size_t flush();
+};
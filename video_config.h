@@ -26,4 +26,11 @@ struct VideoConfig {
     int qp = 20;
     bool enable_cabac = true;
     bool enable_deblock = true;
+
+    // Çok yollu (NovaEngine) taşıma: 0 = tek port RTP. N > 0 ise access unit'ler N tünel
+    // portuna slice'lanır; portlar local_port/remote_port'tan itibaren ardışıktır.
+    int multipath_tunnels = 0;
+    int multipath_fec_parity = 1;           // Delta frame başına parity
+    int multipath_keyframe_fec_parity = 4;  // Keyframe başına parity
+    int multipath_playout_ms = 120;         // rtpjitterbuffer latency karşılığı
 };
\ No newline at end of file
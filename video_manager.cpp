@@ -1,10 +1,16 @@
 // video_manager.cpp - Video işleme yöneticisi implementation
 #include "video_manager.h"
+#include "frame_handle_gst.h"
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <endian.h>
 
 VideoManager::VideoManager(const VideoConfig& cfg)
     : send_pipeline(nullptr), receive_pipeline(nullptr), is_running(false),
-      config(cfg), builder(cfg) {}
+      config(cfg), builder(cfg), multipath_sink(nullptr), multipath_src(nullptr), first_pts_ns(0) {}
 
 VideoManager::~VideoManager() {
     if (is_running) {
@@ -50,8 +56,11 @@ void VideoManager::run_pipeline_loop(GstElement* pipeline, const std::string& pi
 bool VideoManager::initialize(const std::string& remote_ip, int remote_port, int local_port) {
     gst_init(nullptr, nullptr);
 
-    std::string send_pipeline_str = builder.buildSenderPipeline(remote_ip, remote_port);
-    std::string receive_pipeline_str = builder.buildReceiverPipeline(local_port);
+    const bool multipath = config.multipath_tunnels > 0;
+    std::string send_pipeline_str = multipath ? builder.buildMultipathSenderPipeline()
+                                              : builder.buildSenderPipeline(remote_ip, remote_port);
+    std::string receive_pipeline_str = multipath ? builder.buildMultipathReceiverPipeline()
+                                                 : builder.buildReceiverPipeline(local_port);
 
     std::cout << "\n--- GStreamer Pipeline'lar ---" << std::endl;
     std::cout << "[GÖNDERİCİ]: " << send_pipeline_str << std::endl;
@@ -76,9 +85,130 @@ bool VideoManager::initialize(const std::string& remote_ip, int remote_port, int
         return false;
     }
 
+    if (multipath && !initialize_multipath(remote_ip, remote_port, local_port)) {
+        release_multipath();
+        gst_object_unref(send_pipeline);
+        gst_object_unref(receive_pipeline);
+        send_pipeline = nullptr;
+        receive_pipeline = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool VideoManager::initialize_multipath(const std::string& remote_ip, int remote_port, int local_port) {
+    multipath_sink = gst_bin_get_by_name(GST_BIN(send_pipeline), "multipath_sink");
+    multipath_src = gst_bin_get_by_name(GST_BIN(receive_pipeline), "multipath_src");
+    if (!multipath_sink || !multipath_src) {
+        std::cerr << "Çok yollu pipeline elemanları (appsink/appsrc) bulunamadı." << std::endl;
+        return false;
+    }
+
+    // Tünel i: remote_port + i'ye gönderilir, local_port + i'den alınır
+    std::vector<int> remote_ports, local_ports;
+    std::vector<std::string> local_ips;
+    for (int i = 0; i < config.multipath_tunnels; ++i) {
+        remote_ports.push_back(remote_port + i);
+        local_ports.push_back(local_port + i);
+        local_ips.push_back("0.0.0.0");
+    }
+
+    TunnelSenderConfig sender_config;
+    sender_config.fec_parity = static_cast<uint8_t>(config.multipath_fec_parity);
+    sender_config.keyframe_fec_parity = static_cast<uint8_t>(config.multipath_keyframe_fec_parity);
+    tunnel_sender = std::make_unique<TunnelSender>(remote_ip, remote_ports, sender_config);
+    if (!tunnel_sender->is_open()) {
+        std::cerr << "Tünel göndericisi açılamadı: " << remote_ip << std::endl;
+        return false;
+    }
+
+    // Sıralı teslim: eksik frame playout süresi kadar beklenir (FEC + NACK için), sonra atlanır.
+    // Bağımlı frame'ler engine'de atıldığından decoder'a yalnızca çözülebilir frame'ler gider.
+    // Bekleme tabanı bir frame aralığıdır: gönderici frame'i tek burst'te yollar, darboğaz
+    // bağlantı burst'ü en fazla bir frame aralığına yayar (daha uzunu bitrate'i taşıyamaz).
+    const int playout_ms = std::max(config.multipath_playout_ms, 10);
+    const int frame_interval_ms = (1000 + std::max(config.framerate, 1) - 1) / std::max(config.framerate, 1);
+    reassembly_engine = std::make_unique<ReassemblyEngine>();
+    reassembly_engine->set_playout_delay(std::chrono::milliseconds(playout_ms));
+    reassembly_engine->set_wait_time_limits(std::chrono::milliseconds(std::min(frame_interval_ms, playout_ms / 2)),
+                                            std::chrono::milliseconds(playout_ms / 2));
+    reassembly_engine->set_frame_handle_callback([this](FrameHandle&& frame) {
+        push_reassembled_frame(std::move(frame));
+    });
+    if (!reassembly_engine->initialize(local_ips, local_ports)) {
+        std::cerr << "Reassembly Engine başlatılamadı (port " << local_port << "-"
+                  << local_port + config.multipath_tunnels - 1 << ")." << std::endl;
+        return false;
+    }
+    first_pts_ns = UINT64_MAX;
+
+    std::cout << "✓ Çok yollu mod: " << config.multipath_tunnels << " tünel, FEC "
+              << config.multipath_fec_parity << "/" << config.multipath_keyframe_fec_parity
+              << " (keyframe), playout " << playout_ms << "ms" << std::endl;
     return true;
 }
 
+void VideoManager::release_multipath() {
+    reassembly_engine.reset();
+    tunnel_sender.reset();
+    if (multipath_sink) {
+        gst_object_unref(multipath_sink);
+        multipath_sink = nullptr;
+    }
+    if (multipath_src) {
+        gst_object_unref(multipath_src);
+        multipath_src = nullptr;
+    }
+}
+
+void VideoManager::run_multipath_sender() {
+    GstAppSink* sink = GST_APP_SINK(multipath_sink);
+
+    while (is_running.load()) {
+        // Kısa timeout: frame yokken de NACK ve probe'lar yanıtlanır
+        GstSample* sample = gst_app_sink_try_pull_sample(sink, 10 * GST_MSECOND);
+        if (sample) {
+            GstBuffer* buffer = gst_sample_get_buffer(sample);
+            GstMapInfo map;
+            if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+                const bool keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+                const uint64_t pts = GST_BUFFER_PTS_IS_VALID(buffer) ? GST_BUFFER_PTS(buffer) : 0;
+                tunnel_sender->send_frame(map.data, map.size, pts, keyframe);
+                gst_buffer_unmap(buffer, &map);
+            }
+            gst_sample_unref(sample);
+        } else if (gst_app_sink_is_eos(sink)) {
+            break;
+        }
+        tunnel_sender->poll_feedback();
+    }
+}
+
+void VideoManager::push_reassembled_frame(FrameHandle&& frame) {
+    if (frame.size() <= ACCESS_UNIT_PREFIX_SIZE) {
+        return;
+    }
+
+    // Önekteki gönderici PTS'i, alıcı pipeline'ında ilk frame'e göre sıfırlanır
+    uint64_t pts_be;
+    memcpy(&pts_be, frame.data(), sizeof(pts_be));
+    const uint64_t pts = be64toh(pts_be);
+    if (first_pts_ns == UINT64_MAX) {
+        first_pts_ns = pts;
+    }
+    const GstClockTime timestamp = pts >= first_pts_ns ? pts - first_pts_ns : 0;
+
+    // Kopyasız: GstBuffer engine'in havuz buffer'ını sarar, decoder bırakınca havuza döner
+    GstBuffer* buffer = frame_handle_to_gst_buffer(std::move(frame), ACCESS_UNIT_PREFIX_SIZE);
+    if (!buffer) {
+        return;
+    }
+    GST_BUFFER_PTS(buffer) = timestamp;
+    GST_BUFFER_DTS(buffer) = timestamp; // B-frame yok: decode sırası = gösterim sırası
+    gst_app_src_push_buffer(GST_APP_SRC(multipath_src), buffer); // Sahiplik appsrc'ye geçer
+}
+
 bool VideoManager::start() {
     if (!send_pipeline || !receive_pipeline) { // Removed self_view_pipeline check
         std::cerr << "Hata: Pipeline'lar başlatılamadan önce initialize() çağrılmalı." << std::endl;
@@ -111,6 +241,12 @@ bool VideoManager::start() {
 
     is_running = true;
 
+    // Çok yollu mod: alım engine'i ve encoder çıktısını tünellere dağıtan thread
+    if (reassembly_engine) {
+        reassembly_engine->run();
+        multipath_send_thread = std::thread(&VideoManager::run_multipath_sender, this);
+    }
+
     // Thread'leri başlat
     // self_view_thread = std::thread(&VideoManager::run_pipeline_loop, this, self_view_pipeline, "Kendi Görüntü"); // Removed as per edit hint
     receive_thread = std::thread(&VideoManager::run_pipeline_loop, this, receive_pipeline, "Alıcı");
@@ -120,8 +256,22 @@ bool VideoManager::start() {
 }
 
 void VideoManager::stop() {
-    if (!is_running.exchange(false)) {
-        return; // Zaten durdurulmuş
+    // Pipeline hata/EOS ile kendiliğinden durduysa is_running zaten false'tur; thread'ler yine
+    // de toplanmalı (joinable std::thread yıkılırsa terminate)
+    is_running = false;
+
+    // Çok yollu mod: önce gönderim thread'i ve engine (EOS'tan sonra appsrc'ye frame itilmesin)
+    if (multipath_send_thread.joinable()) {
+        multipath_send_thread.join();
+    }
+    if (multipath_sink) {
+        // Artık çeken yok: appsink max-buffers'a dolunca encoder thread'i render'da bloke kalır
+        // ve EOS sink'e hiç ulaşmaz (send_thread join'de asılı kalır). drop açılınca bekleyen
+        // render bırakılır, kalan buffer'lar atılır.
+        gst_app_sink_set_drop(GST_APP_SINK(multipath_sink), TRUE);
+    }
+    if (reassembly_engine) {
+        reassembly_engine->stop();
     }
 
     // Pipeline'lara EOS (End-of-Stream) göndererek nazikçe kapatmayı dene
@@ -140,6 +290,8 @@ void VideoManager::stop() {
         receive_thread.join();
     }
 
+    release_multipath();
+
     // Pipeline'ları NULL durumuna getir ve kaynakları serbest bırak
     if (send_pipeline) {
         gst_element_set_state(send_pipeline, GST_STATE_NULL);
@@ -2,6 +2,8 @@
 #pragma once
 #include "video_config.h"
 #include "pipeline_builder.h"
+#include "reassembly_engine.h"
+#include "tunnel_sender.h"
 #include <gst/gst.h>
 #include <thread>
 #include <atomic>
@@ -20,7 +22,20 @@ private:
     const VideoConfig& config;
     PipelineBuilder builder;
 
+    // Çok yollu mod (config.multipath_tunnels > 0): encoder appsink'inden TunnelSender'a,
+    // ReassemblyEngine'den decoder appsrc'sine
+    std::unique_ptr<TunnelSender> tunnel_sender;
+    std::unique_ptr<ReassemblyEngine> reassembly_engine;
+    GstElement* multipath_sink;
+    GstElement* multipath_src;
+    std::thread multipath_send_thread;
+    uint64_t first_pts_ns; // Alınan ilk frame'in PTS'i (yalnızca engine teslim thread'i)
+
     void run_pipeline_loop(GstElement* pipeline, const std::string& pipeline_name);
+    bool initialize_multipath(const std::string& remote_ip, int remote_port, int local_port);
+    void release_multipath();
+    void run_multipath_sender();
+    void push_reassembled_frame(FrameHandle&& frame);
 
 public:
     VideoManager(const VideoConfig& cfg);